@@ -1,69 +1,252 @@
+#include <algorithm>
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <random>
 #include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include "../src/zipf_generator.h"
 using namespace std;
+using namespace std::chrono;
+
+/**
+ * 测试语料生成器
+ *
+ * 用法: generate_large_text [选项]
+ *   --output FILE   输出文件（默认 test.txt）
+ *   --seed N        随机种子（默认 42），种子和其余参数相同时输出逐字节相同
+ *   --words N       单词总数（默认 500000）
+ *   --size S        目标大小，可带 K/M/G 后缀，例如 2G；指定后代替 --words，在不超过 S 的最后一个单词处结束
+ *   --zipf S        按 Zipf(S) 分布从词表中取词；不指定时使用原来的 30% 高频词 / 30% 中频词 / 40% 随机词
+ *   --vocab N       Zipf 模式的词表大小（默认 100000），排名最前的是 10 个预定义的高频词
+ *   --drift D       工作集漂移：每过一个周期，排名到单词的对应关系整体平移 D 个位置（默认 0，不漂移）
+ *   --epoch N       漂移周期的单词数（默认 1000000）
+ *   --threads N     生成线程数（默认为硬件线程数，最多 MAX_BLOCKS_IN_FLIGHT 个），不影响输出内容
+ *
+ * 输出按 BLOCK_WORDS 个单词分块，每块使用由 (种子, 块号) 派生的独立随机数引擎，
+ * 因此可以多线程并行生成，且结果与线程数无关。各线程把一块写进自己的缓冲区，
+ * 主线程按块号顺序用大块 fwrite 写出。单词之间以空格分隔，每 100 个单词换行。
+ *
+ * 内存占用：每块的缓冲区按每个单词 10 字节预留，约 10 MB（实际平均约 9 字节）；
+ * 同时在内存中的块数等于线程数，线程数不超过 MAX_BLOCKS_IN_FLIGHT，
+ * 因此块缓冲最多约 80 MB，另加 16 MB 写缓冲。
+ */
+
+const uint64_t BLOCK_WORDS = 1 << 20;   // 每块的单词数，是 100 的倍数，换行位置与分块无关
+const size_t WRITE_BUFFER_SIZE = 1 << 24;
+const unsigned MAX_BLOCKS_IN_FLIGHT = 8;  // 同时生成的块数上限，决定内存占用，与机器的核数无关
+
+struct Config {
+    string output = "test.txt";
+    uint64_t seed = 42;
+    uint64_t words = 500000;
+    uint64_t sizeBytes = 0;     // 0 表示按单词数
+    double zipf = 0;            // 0 表示原来的混合模式
+    size_t vocab = 100000;
+    size_t drift = 0;
+    uint64_t epoch = 1000000;
+    unsigned threads = 0;
+};
+
+// 预定义的高频词
+const vector<string> HIGH_FREQ_WORDS = {
+    "computer", "data", "algorithm", "system", "network",
+    "program", "software", "database", "memory", "processor"
+};
 
 // 生成随机单词
-string generateRandomWord(int len, mt19937& gen) {
+string generateRandomWord(int len, mt19937_64& gen) {
     string word;
     static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
     uniform_int_distribution<> dis(0, 25);
-    
+
     for (int i = 0; i < len; ++i) {
         word += charset[dis(gen)];
     }
     return word;
 }
 
-int main() {
-    // 设置输出文件
-    ofstream outFile("test.txt");
-    if (!outFile) {
-        cout << "无法创建文件!" << endl;
-        return 1;
+/**
+ * 词表：前面是预定义的高频词，其余为互不相同的随机单词 - 时间复杂度: O(n)
+ * 只由种子决定；混合模式下用作 100 个中频词
+ */
+vector<string> makeVocabulary(size_t n, uint64_t seed) {
+    mt19937_64 gen(seed);
+    uniform_int_distribution<> wordLen(4, 12);
+    vector<string> vocab(HIGH_FREQ_WORDS.begin(), HIGH_FREQ_WORDS.end());
+    unordered_set<string> seen(vocab.begin(), vocab.end());
+    while (vocab.size() < n) {
+        string word = generateRandomWord(wordLen(gen), gen);
+        if (seen.insert(word).second) vocab.push_back(std::move(word));
     }
+    vocab.resize(n);
+    return vocab;
+}
 
-    // 初始化随机数生成器
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> word_len(4, 12);
-    uniform_int_distribution<> pattern_dis(0, 100);
-
-    // 预定义的高频词
-    vector<string> highFreqWords = {
-        "computer", "data", "algorithm", "system", "network",
-        "program", "software", "database", "memory", "processor"
-    };
-
-    // 预定义的中频词
-    vector<string> mediumFreqWords;
-    for (int i = 0; i < 100; ++i) {
-        mediumFreqWords.push_back(generateRandomWord(word_len(gen), gen));
+// 解析带 K/M/G 后缀的字节数
+uint64_t parseSize(const string& text) {
+    size_t pos = 0;
+    double value = stod(text, &pos);
+    double unit = 1;
+    if (pos < text.size()) {
+        switch (text[pos]) {
+        case 'k': case 'K': unit = 1024.0; break;
+        case 'm': case 'M': unit = 1024.0 * 1024; break;
+        case 'g': case 'G': unit = 1024.0 * 1024 * 1024; break;
+        default: throw invalid_argument("无法识别的大小: " + text);
+        }
     }
+    if (value <= 0) throw invalid_argument("大小必须为正数: " + text);
+    return static_cast<uint64_t>(value * unit);
+}
 
-    // 生成约50万个单词
-    const int TARGET_WORDS = 500000;
-    
-    for (int i = 0; i < TARGET_WORDS; ++i) {
-        int pattern = pattern_dis(gen);
-        
-        if (pattern < 30) { // 30% 概率选择高频词
-            outFile << highFreqWords[gen() % highFreqWords.size()] << " ";
-        }
-        else if (pattern < 60) { // 30% 概率选择中频词
-            outFile << mediumFreqWords[gen() % mediumFreqWords.size()] << " ";
-        }
-        else { // 40% 概率生成随机词
-            outFile << generateRandomWord(word_len(gen), gen) << " ";
+/**
+ * 生成第 block 块的 count 个单词，追加到 out - 时间复杂度: O(count log vocab)
+ * 块内容只由种子、块号和参数决定
+ */
+void generateBlock(const Config& config, const vector<string>& vocab, const ZipfGenerator* zipf,
+                   uint64_t block, uint64_t count, string& out) {
+    seed_seq seq{uint32_t(config.seed), uint32_t(config.seed >> 32), uint32_t(block), uint32_t(block >> 32)};
+    mt19937_64 gen(seq);
+    uniform_int_distribution<> wordLen(4, 12);
+    uniform_int_distribution<> patternDis(0, 100);
+
+    uint64_t first = block * BLOCK_WORDS;
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t index = first + i;
+        if (zipf) {
+            size_t rank = (*zipf)(gen);
+            size_t shift = config.drift ? size_t((index / config.epoch) * config.drift % vocab.size()) : 0;
+            out += vocab[(rank + shift) % vocab.size()];
+        } else {
+            int pattern = patternDis(gen);
+            if (pattern < 30) { // 30% 概率选择高频词
+                out += HIGH_FREQ_WORDS[gen() % HIGH_FREQ_WORDS.size()];
+            } else if (pattern < 60) { // 30% 概率选择中频词
+                out += vocab[gen() % vocab.size()];
+            } else { // 40% 概率生成随机词
+                out += generateRandomWord(wordLen(gen), gen);
+            }
         }
+        out += ' ';
 
         // 每100个单词换行
-        if (i % 100 == 99) outFile << "\n";
+        if (index % 100 == 99) out += '\n';
+    }
+}
+
+int run(const Config& config) {
+    unsigned threads = config.threads ? config.threads : max(1u, thread::hardware_concurrency());
+    threads = min(threads, MAX_BLOCKS_IN_FLIGHT);
+    uint64_t totalWords = config.sizeBytes ? UINT64_MAX : config.words;
+
+    // 混合模式的 100 个中频词取自词表去掉高频词后的部分
+    vector<string> vocab;
+    if (config.zipf > 0) {
+        vocab = makeVocabulary(max<size_t>(config.vocab, 1), config.seed);
+    } else {
+        vocab = makeVocabulary(HIGH_FREQ_WORDS.size() + 100, config.seed);
+        vocab.erase(vocab.begin(), vocab.begin() + HIGH_FREQ_WORDS.size());
     }
+    unique_ptr<ZipfGenerator> zipf;
+    if (config.zipf > 0) zipf.reset(new ZipfGenerator(vocab.size(), config.zipf));
 
-    outFile.close();
-    cout << "已生成大型测试文件 test.txt" << endl;
+    FILE* out = fopen(config.output.c_str(), "wb");
+    if (!out) {
+        cout << "无法创建文件!" << endl;
+        return 1;
+    }
+    vector<char> writeBuffer(WRITE_BUFFER_SIZE);
+    setvbuf(out, writeBuffer.data(), _IOFBF, writeBuffer.size());
+
+    auto start = high_resolution_clock::now();
+    vector<string> buffers(threads);
+    uint64_t wordsWritten = 0, bytesWritten = 0;
+    bool done = false;
+    for (uint64_t round = 0; !done; round++) {
+        // 每轮各线程生成一块，再按块号顺序写出
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            uint64_t block = round * threads + t;
+            uint64_t first = block * BLOCK_WORDS;
+            buffers[t].clear();
+            if (first >= totalWords) continue;
+            uint64_t count = min<uint64_t>(BLOCK_WORDS, totalWords - first);
+            workers.emplace_back([&, t, block, count] {
+                buffers[t].reserve(count * 10);
+                generateBlock(config, vocab, zipf.get(), block, count, buffers[t]);
+            });
+        }
+        for (auto& w : workers) w.join();
+
+        for (unsigned t = 0; t < threads && !done; t++) {
+            const string& data = buffers[t];
+            if (data.empty()) {
+                done = true;
+                break;
+            }
+            size_t length = data.size();
+            if (config.sizeBytes && bytesWritten + length >= config.sizeBytes) {
+                // 在不超过目标大小的最后一个单词之后结束
+                length = size_t(config.sizeBytes - bytesWritten);
+                while (length > 0 && data[length - 1] != ' ' && data[length - 1] != '\n') length--;
+                done = true;
+            }
+            fwrite(data.data(), 1, length, out);
+            bytesWritten += length;
+            for (size_t i = 0; i < length; i++) wordsWritten += data[i] == ' ';
+            if (!config.sizeBytes && wordsWritten >= totalWords) done = true;
+        }
+    }
+    bool ok = fclose(out) == 0;
+    auto end = high_resolution_clock::now();
+    double seconds = duration_cast<microseconds>(end - start).count() / 1e6;
+
+    if (!ok) {
+        cout << "写入文件失败!" << endl;
+        return 1;
+    }
+    cout << "已生成测试文件 " << config.output << endl;
+    cout << "单词数: " << wordsWritten << ", 大小: " << bytesWritten << " 字节, 种子: " << config.seed << endl;
+    if (config.zipf > 0) {
+        cout << "分布: Zipf(" << config.zipf << "), 词表 " << vocab.size() << " 个单词";
+        if (config.drift) cout << ", 每 " << config.epoch << " 个单词漂移 " << config.drift << " 个位置";
+        cout << endl;
+    } else {
+        cout << "分布: 30% 高频词 / 30% 中频词 / 40% 随机词" << endl;
+    }
+    cout << "线程数: " << threads << ", 耗时: " << fixed << setprecision(2) << seconds << " 秒, "
+         << bytesWritten / 1e6 / max(seconds, 1e-9) << " MB/秒" << endl;
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    Config config;
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (i + 1 >= argc) throw invalid_argument("缺少参数值: " + arg);
+            string value = argv[++i];
+            if (arg == "--output") config.output = value;
+            else if (arg == "--seed") config.seed = stoull(value);
+            else if (arg == "--words") config.words = stoull(value);
+            else if (arg == "--size") config.sizeBytes = parseSize(value);
+            else if (arg == "--zipf") config.zipf = stod(value);
+            else if (arg == "--vocab") config.vocab = stoull(value);
+            else if (arg == "--drift") config.drift = stoull(value);
+            else if (arg == "--epoch") config.epoch = max<uint64_t>(1, stoull(value));
+            else if (arg == "--threads") config.threads = unsigned(stoul(value));
+            else throw invalid_argument("未知选项: " + arg);
+        }
+        return run(config);
+    } catch (const exception& e) {
+        cout << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
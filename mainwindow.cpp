@@ -232,9 +232,12 @@ void MainWindow::onSplitClicked() {
                           .arg(val));
     
     // 添加内存使用状态检查
-    QString memStatus = QString("当前节点数: %1, 总分配次数: %2")
+    QString memStatus = QString("当前节点数: %1, 峰值节点数: %2, 总分配次数: %3, 占用内存: %4 字节, 内存块数: %5")
                         .arg(m_tree.get_current_nodes())
-                        .arg(m_tree.get_total_allocations());
+                        .arg(m_tree.get_peak_nodes())
+                        .arg(m_tree.get_total_allocations())
+                        .arg(m_tree.get_bytes_in_use())
+                        .arg(m_tree.get_chunk_count());
     ui->textBrowser->append(memStatus);
 }
 
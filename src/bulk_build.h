@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "node_pool.h"
+
+/**
+ * 由有序序列线性时间构建完全平衡的二叉搜索树
+ *
+ * 节点类型需要有 left/right/parent 指针和 size 字段（SplayTree 与词频统计的 Node 都满足）。
+ * 所有节点一次性从内存池取得一段连续槽位，按中序下标构造：
+ * - 构造：make(storage, i) 在 storage 上构造中序第 i 个节点
+ * - 链接：区间 [lo, hi) 的中点作为子树根，左右两半递归链接，递归深度 O(log n)
+ *
+ * threads > 1 时，构造阶段把下标区间切成 threads 段并行构造，
+ * 链接阶段在较大的子树上分出线程并行链接左半部分。
+ */
+namespace bulk_build {
+
+// 子树小于该规模时不再分出线程
+const size_t PARALLEL_CUTOFF = 1 << 16;
+
+template<typename Node>
+Node* link(Node* base, size_t lo, size_t hi, Node* parent, unsigned threads) {
+    if (lo >= hi) return nullptr;
+    size_t mid = lo + (hi - lo) / 2;
+    Node* x = NodePool<Node>::run_slot(base, mid);
+    x->parent = parent;
+
+    bool forked = false;
+    if (threads > 1 && hi - lo > PARALLEL_CUTOFF) {
+        try {
+            std::thread worker([&] { x->left = link(base, lo, mid, x, threads / 2); });
+            x->right = link(base, mid + 1, hi, x, threads - threads / 2);
+            worker.join();
+            forked = true;
+        } catch (const std::system_error&) {
+            // 无法创建线程时退回单线程链接
+        }
+    }
+    if (!forked) {
+        x->left = link(base, lo, mid, x, 1u);
+        x->right = link(base, mid + 1, hi, x, 1u);
+    }
+    x->size = static_cast<decltype(x->size)>(hi - lo);
+    return x;
+}
+
+/**
+ * 构建并返回根节点 - 时间复杂度: O(n)，并行时跨度为 O(n / threads + log n)
+ * make 抛出异常时已构造的节点会被析构，全部槽位归还内存池，然后重新抛出
+ */
+template<typename Node, typename Make>
+Node* build(NodePool<Node>& pool, size_t n, Make&& make, unsigned threads = 1) {
+    if (n == 0) return nullptr;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, (n + PARALLEL_CUTOFF - 1) / PARALLEL_CUTOFF));
+    if (threads == 0) threads = 1;
+
+    Node* base = pool.allocate_run(n);
+
+    // 构造阶段：每段记录成功构造的个数，失败时据此清理
+    std::vector<size_t> constructed(threads, 0);
+    std::vector<std::exception_ptr> errors(threads);
+    auto construct_range = [&](unsigned t) {
+        size_t lo = n * t / threads, hi = n * (t + 1) / threads;
+        try {
+            for (size_t i = lo; i < hi; i++) {
+                make(static_cast<void*>(NodePool<Node>::run_slot(base, i)), i);
+                constructed[t]++;
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++) {
+        try {
+            workers.emplace_back(construct_range, t);
+        } catch (const std::system_error&) {
+            construct_range(t);
+        }
+    }
+    construct_range(0);
+    for (auto& w : workers) w.join();
+
+    for (unsigned t = 0; t < threads; t++) {
+        if (!errors[t]) continue;
+        for (unsigned u = 0; u < threads; u++) {
+            size_t lo = n * u / threads, hi = n * (u + 1) / threads;
+            for (size_t i = lo; i < hi; i++) {
+                Node* slot = NodePool<Node>::run_slot(base, i);
+                if (i < lo + constructed[u]) pool.deallocate(slot);
+                else pool.release_unconstructed(slot);
+            }
+        }
+        std::rethrow_exception(errors[t]);
+    }
+
+    return link(base, 0, n, static_cast<Node*>(nullptr), threads);
+}
+
+} // namespace bulk_build
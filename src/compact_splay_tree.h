@@ -0,0 +1,447 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * 紧凑存储模式的伸展树
+ *
+ * 与 SplayTree 提供相同的 insert/find/erase/split/merge 接口，区别在于存储方式
+ * （insert 返回节点下标而不是指针，下标在扩容后仍然有效）：
+ * - 所有节点存放在一个连续的 std::vector 中
+ * - 节点之间用 32 位下标而不是 64 位指针相互连接
+ *
+ * 以 int 为键时每个节点只占 20 字节（指针模式为 40 字节），
+ * 旋转时访问的缓存行更少。代价是单棵存储最多容纳 NIL 个节点（约 40 亿），
+ * 超出时 insert 抛出 std::length_error；且 insert 可能触发 vector 扩容，
+ * 使之前 find 返回的节点指针失效。
+ *
+ * 拆分得到的两棵树与原树共享同一块节点存储，因此拆分和合并都不需要搬移节点；
+ * 节点记录子树大小，拆分时直接读出左树的节点数，不需要遍历。
+ */
+template<typename T, typename Comp = std::less<T>>
+class CompactSplayTree {
+public:
+    using index_type = uint32_t;
+    static const index_type NIL = std::numeric_limits<index_type>::max();
+
+    struct node {
+        index_type left = NIL;
+        index_type right = NIL;
+        index_type parent = NIL;// 空闲节点借用 left 字段串成空闲链表
+        index_type size = 1;// 以该节点为根的子树大小，旋转时维护
+        T key;
+
+        explicit node(const T& k) : key(k) {}
+    };
+
+private:
+    // 节点存储，可被拆分出的多棵树共享
+    struct store {
+        std::vector<node> nodes;
+        index_type free_head = NIL;
+
+        index_type allocate(const T& key) {
+            if (free_head != NIL) {
+                index_type i = free_head;
+                free_head = nodes[i].left;
+                nodes[i].left = nodes[i].right = nodes[i].parent = NIL;
+                nodes[i].size = 1;
+                nodes[i].key = key;
+                return i;
+            }
+            // NIL 本身不能用作下标，下标只能到 NIL - 1
+            if (nodes.size() >= NIL) throw std::length_error("CompactSplayTree: 节点数超过 32 位下标的上限");
+            nodes.emplace_back(key);
+            return static_cast<index_type>(nodes.size() - 1);
+        }
+
+        void deallocate(index_type i) {
+            nodes[i].right = nodes[i].parent = NIL;
+            nodes[i].left = free_head;
+            free_head = i;
+        }
+    };
+
+    std::shared_ptr<store> s;
+
+    node& at(index_type i) { return s->nodes[i]; }
+    const node& at(index_type i) const { return s->nodes[i]; }
+
+    index_type subtree_size(index_type i) const { return i == NIL ? 0 : at(i).size; }
+
+    explicit CompactSplayTree(std::shared_ptr<store> shared)
+        : s(std::move(shared)), p_size(0), root(NIL) {}
+
+public:
+    // 基本属性
+    Comp comp;
+    unsigned long p_size;// 节点数量
+    index_type root;
+
+    CompactSplayTree() : s(std::make_shared<store>()), p_size(0), root(NIL) {}
+
+    // 复制构造：只复制本树可达的节点，结果拥有独立的存储
+    CompactSplayTree(const CompactSplayTree& other) : CompactSplayTree() {
+        comp = other.comp;
+        if (other.root != NIL) {
+            s->nodes.reserve(other.p_size);
+            root = copy_tree(other, other.root, NIL);
+            p_size = other.p_size;
+        }
+    }
+
+    CompactSplayTree(CompactSplayTree&& other) noexcept
+        : s(std::move(other.s)), comp(other.comp), p_size(other.p_size), root(other.root) {
+        other.s = std::make_shared<store>();
+        other.root = NIL;
+        other.p_size = 0;
+    }
+
+    CompactSplayTree& operator=(const CompactSplayTree& other) {
+        if (this != &other) {
+            CompactSplayTree tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    CompactSplayTree& operator=(CompactSplayTree&& other) noexcept {
+        if (this != &other) {
+            clear(root);
+            comp = std::move(other.comp);
+            s = std::move(other.s);
+            root = other.root;
+            p_size = other.p_size;
+            other.s = std::make_shared<store>();
+            other.root = NIL;
+            other.p_size = 0;
+        }
+        return *this;
+    }
+
+    ~CompactSplayTree() {
+        // 独占存储时直接随 vector 一起释放，否则把节点还给共享存储
+        if (s && s.use_count() > 1) clear(root);
+    }
+
+    // 通过下标访问节点，供遍历和可视化使用
+    node& operator[](index_type i) { return at(i); }
+    const node& operator[](index_type i) const { return at(i); }
+
+    /**
+     * 插入操作 - 时间复杂度: 平摊 O(log n)
+     * 返回 key 所在节点（新插入的或已存在的）的下标，伸展后它就是根
+     */
+    index_type insert(const T &key) {
+        if (root == NIL) {
+            root = s->allocate(key);
+            p_size++;
+            return root;
+        }
+
+        index_type z = root;
+        index_type p = NIL;
+
+        while (z != NIL) {
+            p = z;
+            if (comp(key, at(z).key))
+                z = at(z).left;
+            else if (comp(at(z).key, key))
+                z = at(z).right;
+            else {
+                splay(z);
+                return z;
+            }
+        }
+
+        z = s->allocate(key);// 可能触发扩容，之后才能取引用
+        at(z).parent = p;
+        if (comp(key, at(p).key))
+            at(p).left = z;
+        else
+            at(p).right = z;
+        for (index_type a = p; a != NIL; a = at(a).parent) at(a).size++;
+
+        splay(z);
+        p_size++;
+        return z;
+    }
+
+    /**
+     * 查找操作 - 时间复杂度: 平摊 O(log n)
+     * 返回的指针在下一次 insert 之前有效
+     */
+    node* find(const T &key) {
+        if (root == NIL) return nullptr;
+
+        index_type last_accessed = root;
+        index_type current = root;
+
+        while (current != NIL) {
+            last_accessed = current;
+            if (comp(at(current).key, key)) {
+                current = at(current).right;
+            } else if (comp(key, at(current).key)) {
+                current = at(current).left;
+            } else {
+                splay(current);
+                return &at(current);
+            }
+        }
+
+        splay(last_accessed);
+        return nullptr;
+    }
+
+    /**
+     * 删除操作 - 时间复杂度: 平摊 O(log n)
+     */
+    void erase(const T &key) {
+        if (!find(key)) return;
+        index_type target = root;
+
+        index_type left_tree = at(target).left;
+        index_type right_tree = at(target).right;
+        if (left_tree != NIL) at(left_tree).parent = NIL;
+        if (right_tree != NIL) at(right_tree).parent = NIL;
+
+        if (left_tree == NIL) {
+            root = right_tree;
+        } else {
+            index_type max_node = subtree_maximum(left_tree);
+            splay(max_node);
+            at(max_node).right = right_tree;
+            at(max_node).size += subtree_size(right_tree);
+            if (right_tree != NIL) at(right_tree).parent = max_node;
+            root = max_node;
+        }
+
+        s->deallocate(target);
+        p_size--;
+    }
+
+    /**
+     * 树的拆分操作 - 时间复杂度: 平摊 O(log n)
+     * 左树中所有键值小于等于 key，右树中所有键值大于 key
+     * 两棵新树与原树共享节点存储，不搬移节点
+     */
+    std::pair<CompactSplayTree*, CompactSplayTree*> split(const T& key) {
+        auto* left = new CompactSplayTree(s);
+        auto* right = new CompactSplayTree(s);
+        left->comp = right->comp = comp;
+        if (root == NIL) return {left, right};
+
+        find(key);
+
+        if (!comp(key, at(root).key)) {// key >= root->key
+            left->root = root;
+            index_type r = at(root).right;
+            if (r != NIL) {
+                right->root = r;
+                at(r).parent = NIL;
+                at(root).right = NIL;
+                at(root).size -= at(r).size;
+            }
+        } else {
+            right->root = root;
+            index_type l = at(root).left;
+            if (l != NIL) {
+                left->root = l;
+                at(l).parent = NIL;
+                at(root).left = NIL;
+                at(root).size -= at(l).size;
+            }
+        }
+
+        left->p_size = subtree_size(left->root);
+        right->p_size = p_size - left->p_size;
+
+        root = NIL;
+        p_size = 0;
+        return {left, right};
+    }
+
+    /**
+     * 树的合并操作 - 时间复杂度: 平摊 O(log n)
+     * 前提是 t1 中的所有键值必须小于 t2 中的所有键值，否则返回 nullptr
+     * 两棵树不共享存储时需要先把 t2 的节点复制过来，退化为 O(m)
+     */
+    static CompactSplayTree* merge(CompactSplayTree* t1, CompactSplayTree* t2) {
+        if (!t1 || t1->root == NIL) {
+            auto* result = t2 ? new CompactSplayTree(std::move(*t2)) : new CompactSplayTree();
+            delete t1;
+            delete t2;
+            return result;
+        }
+        if (!t2 || t2->root == NIL) {
+            auto* result = new CompactSplayTree(std::move(*t1));
+            delete t1;
+            delete t2;
+            return result;
+        }
+
+        index_type max_node = t1->subtree_maximum(t1->root);
+        index_type min_node = t2->subtree_minimum(t2->root);
+        if (!t1->comp(t1->at(max_node).key, t2->at(min_node).key)) {
+            delete t1;
+            delete t2;
+            return nullptr;
+        }
+
+        index_type right_root = t2->root;
+        unsigned long right_size = t2->p_size;
+        if (t1->s != t2->s) {
+            right_root = t1->copy_tree(*t2, t2->root, NIL);
+            t2->clear(t2->root);
+        }
+        t2->root = NIL;
+
+        t1->splay(max_node);
+        t1->at(t1->root).right = right_root;
+        t1->at(t1->root).size += t1->at(right_root).size;
+        t1->at(right_root).parent = t1->root;
+
+        auto* result = new CompactSplayTree(std::move(*t1));
+        result->p_size += right_size;
+        t2->p_size = 0;
+
+        delete t1;
+        delete t2;
+        return result;
+    }
+
+    // 释放以 x 为根的子树，节点回到存储的空闲链表
+    void clear(index_type x) {
+        if (x == NIL) return;
+        std::vector<index_type> stack{x};
+        while (!stack.empty()) {
+            index_type i = stack.back();
+            stack.pop_back();
+            if (at(i).left != NIL) stack.push_back(at(i).left);
+            if (at(i).right != NIL) stack.push_back(at(i).right);
+            s->deallocate(i);
+        }
+        if (x == root) {
+            root = NIL;
+            p_size = 0;
+        }
+    }
+
+    bool empty() const { return root == NIL; }
+    unsigned long size() const { return p_size; }
+
+    // 存储占用（包含空闲链表中的节点）
+    size_t bytes_reserved() const { return s->nodes.capacity() * sizeof(node); }
+
+private:
+    void left_rotate(index_type x) {
+        index_type y = at(x).right;
+        index_type b = at(y).left;
+        index_type p = at(x).parent;
+
+        at(x).right = b;
+        if (b != NIL) at(b).parent = x;
+
+        at(y).parent = p;
+        if (p != NIL) {
+            if (at(p).left == x) at(p).left = y;
+            else at(p).right = y;
+        }
+
+        at(y).left = x;
+        at(x).parent = y;
+
+        at(y).size = at(x).size;
+        at(x).size = 1 + subtree_size(at(x).left) + subtree_size(at(x).right);
+    }
+
+    void right_rotate(index_type x) {
+        index_type y = at(x).left;
+        index_type b = at(y).right;
+        index_type p = at(x).parent;
+
+        at(x).left = b;
+        if (b != NIL) at(b).parent = x;
+
+        at(y).parent = p;
+        if (p != NIL) {
+            if (at(p).left == x) at(p).left = y;
+            else at(p).right = y;
+        }
+
+        at(y).right = x;
+        at(x).parent = y;
+
+        at(y).size = at(x).size;
+        at(x).size = 1 + subtree_size(at(x).left) + subtree_size(at(x).right);
+    }
+
+    /**
+     * 伸展操作 - 时间复杂度: 平摊 O(log n)
+     */
+    void splay(index_type x) {
+        while (at(x).parent != NIL) {
+            index_type p = at(x).parent;
+            index_type g = at(p).parent;
+
+            if (g == NIL) {// Zig
+                if (at(p).left == x) right_rotate(p);
+                else left_rotate(p);
+            } else if (at(g).left == p && at(p).left == x) {// Zig-Zig
+                right_rotate(g);
+                right_rotate(p);
+            } else if (at(g).right == p && at(p).right == x) {// Zig-Zig
+                left_rotate(g);
+                left_rotate(p);
+            } else if (at(g).left == p && at(p).right == x) {// Zig-Zag
+                left_rotate(p);
+                right_rotate(g);
+            } else {// Zig-Zag
+                right_rotate(p);
+                left_rotate(g);
+            }
+        }
+        root = x;
+    }
+
+    index_type subtree_minimum(index_type u) const {
+        while (at(u).left != NIL) u = at(u).left;
+        return u;
+    }
+
+    index_type subtree_maximum(index_type u) const {
+        while (at(u).right != NIL) u = at(u).right;
+        return u;
+    }
+
+    // 把 src 中以 x 为根的子树复制到本树的存储中，返回新子树的根
+    // 用显式栈代替递归；分配可能使存储扩容，因此栈中只保存下标
+    index_type copy_tree(const CompactSplayTree& src, index_type x, index_type parent) {
+        if (x == NIL) return NIL;
+        struct pending { index_type from, parent; bool left; };
+        index_type result = NIL;
+        std::vector<pending> stack{{x, parent, true}};
+        while (!stack.empty()) {
+            pending p = stack.back();
+            stack.pop_back();
+            index_type n = s->allocate(src.at(p.from).key);
+            at(n).parent = p.parent;
+            at(n).size = src.at(p.from).size;
+            if (p.parent == parent) result = n;
+            else if (p.left) at(p.parent).left = n;
+            else at(p.parent).right = n;
+            if (src.at(p.from).left != NIL) stack.push_back({src.at(p.from).left, n, true});
+            if (src.at(p.from).right != NIL) stack.push_back({src.at(p.from).right, n, false});
+        }
+        return result;
+    }
+};
+
+template<typename T, typename Comp>
+const typename CompactSplayTree<T, Comp>::index_type CompactSplayTree<T, Comp>::NIL;
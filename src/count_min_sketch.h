@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+/**
+ * Count-Min sketch：固定内存的近似计数
+ *
+ * depth 行、每行 width 个计数器，每个键在每一行按各自的哈希落到一个计数器上：
+ * - 加一：只把该键所在的计数器中最小的那些抬高（保守更新），比全部加一的误差更小 - O(depth)
+ * - 估计：取该键在各行计数器的最小值 - O(depth)
+ *
+ * 估计值从不低于真实次数；设已加入的总次数为 N，width = ⌈e/ε⌉、depth = ⌈ln(1/δ)⌉ 时，
+ * 估计值超出真实次数 εN 以上的概率不超过 δ。内存只与 ε、δ 有关，与不同键的个数无关，
+ * 适合吸收只出现一两次的长尾键。不做线程同步。
+ */
+template<typename Key, typename Hash = std::hash<Key>>
+class CountMinSketch {
+public:
+    CountMinSketch(double epsilon, double delta)
+        : eps(epsilon),
+          cols(std::max<size_t>(1, static_cast<size_t>(std::ceil(std::exp(1.0) / epsilon)))),
+          rows(std::max<size_t>(1, static_cast<size_t>(std::ceil(std::log(1.0 / delta))))),
+          counters(cols * rows, 0) {}
+
+    /**
+     * 加入 n 次 key，返回加入后的估计值 - 时间复杂度: O(depth)
+     * 计数器饱和时停在 uint32_t 的最大值
+     */
+    uint32_t add(const Key& key, uint32_t n = 1) {
+        uint64_t h1, h2;
+        hash_pair(key, h1, h2);
+        uint32_t current = min_counter(h1, h2);
+        uint64_t raised = static_cast<uint64_t>(current) + n;
+        uint32_t target = static_cast<uint32_t>(std::min<uint64_t>(raised, std::numeric_limits<uint32_t>::max()));
+        for (size_t r = 0; r < rows; r++) {
+            uint32_t& c = counters[r * cols + index(h1, h2, r)];
+            if (c < target) c = target;
+        }
+        n_total += n;
+        return target;
+    }
+
+    // 估计 key 的出现次数 - 时间复杂度: O(depth)
+    uint32_t estimate(const Key& key) const {
+        uint64_t h1, h2;
+        hash_pair(key, h1, h2);
+        return min_counter(h1, h2);
+    }
+
+    size_t width() const { return cols; }
+    size_t depth() const { return rows; }
+    size_t bytes() const { return counters.size() * sizeof(uint32_t); }
+    uint64_t total() const { return n_total; }
+
+    // 当前的误差上界 εN：以 1 - δ 的概率，任一键的估计值不超过真实次数加上这个值
+    double error_bound() const { return eps * static_cast<double>(n_total); }
+
+private:
+    // 一次哈希派生出各行的下标（双重哈希），第二个哈希为奇数，保证各行互不相同
+    void hash_pair(const Key& key, uint64_t& h1, uint64_t& h2) const {
+        uint64_t h = static_cast<uint64_t>(hash(key));
+        h1 = h * 0x9E3779B97F4A7C15ull;
+        h2 = ((h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ull) | 1;
+    }
+
+    size_t index(uint64_t h1, uint64_t h2, size_t r) const {
+        return static_cast<size_t>(((h1 + r * h2) >> 16) % cols);
+    }
+
+    uint32_t min_counter(uint64_t h1, uint64_t h2) const {
+        uint32_t m = std::numeric_limits<uint32_t>::max();
+        for (size_t r = 0; r < rows; r++) m = std::min(m, counters[r * cols + index(h1, h2, r)]);
+        return m;
+    }
+
+    Hash hash;
+    double eps;
+    size_t cols;
+    size_t rows;
+    std::vector<uint32_t> counters;
+    uint64_t n_total = 0;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+/**
+ * 字符串键的前缀缓存
+ *
+ * 节点额外保存键的前 8 个字节，按大端序拼成一个 uint64_t（不足 8 字节补 0）。
+ * 大端序下整数的大小关系与逐字节按无符号比较的字典序一致，所以下降时
+ * 大多数比较只需一次整数比较，不必跟随指针读取字符串本身；前缀相同时才比较剩余部分。
+ * 每层只做一次三路比较，代替 key < x 与 key > x 两次比较。
+ */
+namespace key_prefix {
+
+// 取 s 的前 8 个字节，大端序，不足补 0 - O(1)
+inline uint64_t load(std::string_view s) {
+    unsigned char bytes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    if (!s.empty()) std::memcpy(bytes, s.data(), s.size() < 8 ? s.size() : 8);
+    uint64_t v;
+    std::memcpy(&v, bytes, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    v = __builtin_bswap64(v);
+#elif defined(_MSC_VER)
+    v = _byteswap_uint64(v);
+#endif
+    return v;
+}
+
+/**
+ * 三路比较 a 与 b，pa、pb 为两者的前缀 - 返回值的符号与 a.compare(b) 相同
+ * 前缀不同即可定序；前缀相同且两者都不短于 8 字节时，前 8 个字节一定相同，只比较其后的部分
+ * （较短的键补 0 后可能与含 '\0' 的键前缀相同，这时退回完整比较）
+ */
+inline int compare(uint64_t pa, std::string_view a, uint64_t pb, std::string_view b) {
+    if (pa != pb) return pa < pb ? -1 : 1;
+    if (a.size() >= 8 && b.size() >= 8) return a.substr(8).compare(b.substr(8));
+    return a.compare(b);
+}
+
+/**
+ * 键的比较方式，供 SplayTree 在编译期选择：
+ * - 通用版本：节点不缓存前缀，三路比较由 comp 两次比较组成
+ * - 特化：键为 std::string / std::string_view 且按默认的 std::less 排序时，节点缓存前缀
+ *   （std::char_traits<char> 按无符号字节比较，与前缀的整数序一致）
+ */
+template<typename T, typename Comp, typename = void>
+struct order {
+    static constexpr bool cached = false;
+
+    // 节点基类，不缓存时不占空间
+    struct node_base {
+        explicit node_base(const T&) {}
+    };
+
+    // 一次查找中被比较的键；缓存前缀时在构造时算好前缀，整条下降路径复用
+    struct probe {
+        const T& key;
+        explicit probe(const T& k) : key(k) {}
+
+        template<typename Node>
+        int compare(const Comp& comp, const Node* x) const {
+            if (comp(key, x->key)) return -1;
+            return comp(x->key, key) ? 1 : 0;
+        }
+    };
+};
+
+template<typename T>
+constexpr bool is_string_like = std::is_same<T, std::string>::value || std::is_same<T, std::string_view>::value;
+
+template<typename T, typename Comp>
+struct order<T, Comp, std::enable_if_t<is_string_like<T> &&
+    (std::is_same<Comp, std::less<T>>::value || std::is_same<Comp, std::less<>>::value)>> {
+    static constexpr bool cached = true;
+
+    struct node_base {
+        uint64_t prefix;
+        explicit node_base(const T& k) : prefix(load(k)) {}
+    };
+
+    struct probe {
+        const T& key;
+        uint64_t prefix;
+        explicit probe(const T& k) : key(k), prefix(load(k)) {}
+
+        template<typename Node>
+        int compare(const Comp&, const Node* x) const {
+            return key_prefix::compare(prefix, key, x->prefix, x->key);
+        }
+    };
+};
+
+} // namespace key_prefix
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * 对数分桶的延迟直方图（HDR 风格）
+ *
+ * 每个 2 的幂区间再等分为 SUB_BUCKETS 个子桶，小于 2 * SUB_BUCKETS 的值各占一个桶：
+ * - 记录：一次最高位计算加一次数组自增 - O(1)，不分配内存，适合在计时循环里逐次调用
+ * - 分位数：按桶累加到目标次数 - O(桶数)
+ *
+ * 桶内的相对误差不超过 1 / SUB_BUCKETS（约 3%），分位数取所在桶的上界（不超过最大值），
+ * 与 HdrHistogram 的 "highest equivalent value" 一致。值的单位由调用方决定（这里都用纳秒）。
+ * 不做线程同步，多线程时各自记录后 merge。
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram() : counts(BUCKET_COUNT, 0) {}
+
+    // 记录一个值 - 时间复杂度: O(1)
+    void record(uint64_t value) {
+        counts[index(value)]++;
+        total++;
+        sum += value;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    // 合并另一个直方图 - 时间复杂度: O(桶数)
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKET_COUNT; i++) counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    void clear() {
+        std::fill(counts.begin(), counts.end(), 0);
+        total = sum = maxValue = 0;
+        minValue = std::numeric_limits<uint64_t>::max();
+    }
+
+    /**
+     * 第 p 百分位（0 < p <= 100）：至少 p% 的记录不超过返回值 - 时间复杂度: O(桶数)
+     * 没有记录时返回 0
+     */
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(total)));
+        target = std::min(std::max<uint64_t>(target, 1), total);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            seen += counts[i];
+            if (seen >= target) return std::min(upper(i), maxValue);
+        }
+        return maxValue;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? minValue : 0; }
+    uint64_t max() const { return maxValue; }
+    double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+
+    /**
+     * 输出全部非空桶，每行: 前缀,下界,上界,次数,累计比例
+     * prefix 用于区分同一文件里的多个直方图（例如 "结构,操作"），为空时不输出前缀列
+     */
+    void write(std::ostream& out, const std::string& prefix = std::string()) const {
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            if (counts[i] == 0) continue;
+            seen += counts[i];
+            if (!prefix.empty()) out << prefix << ",";
+            out << lower(i) << "," << upper(i) << "," << counts[i] << ","
+                << static_cast<double>(seen) / static_cast<double>(total) << "\n";
+        }
+    }
+
+    // 桶 i 覆盖的取值范围 [lower(i), upper(i)]
+    static uint64_t lower(size_t i) {
+        if (i < 2 * SUB_BUCKETS) return i;
+        unsigned shift = static_cast<unsigned>(i / SUB_BUCKETS - 1);
+        return (i % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    }
+
+    static uint64_t upper(size_t i) {
+        if (i < 2 * SUB_BUCKETS) return i;
+        unsigned shift = static_cast<unsigned>(i / SUB_BUCKETS - 1);
+        return lower(i) + ((uint64_t(1) << shift) - 1);
+    }
+
+private:
+    // 最高位为 m（m >= SUB_BITS + 1）的值落在第 m - SUB_BITS 组，组内按其后 SUB_BITS 位分桶
+    static size_t index(uint64_t v) {
+        if (v < 2 * SUB_BUCKETS) return static_cast<size_t>(v);
+#ifdef _MSC_VER
+        unsigned long msb;
+        _BitScanReverse64(&msb, v);
+#else
+        unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(v));
+#endif
+        unsigned shift = static_cast<unsigned>(msb) - SUB_BITS;
+        return static_cast<size_t>(shift * SUB_BUCKETS + (v >> shift));
+    }
+
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t minValue = std::numeric_limits<uint64_t>::max();
+    uint64_t maxValue = 0;
+};
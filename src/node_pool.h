@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * 节点内存池（slab 分配器）
+ *
+ * 以连续的 chunk 为单位向系统申请内存，每个 chunk 切分为若干个等大的槽位：
+ * - 分配：优先从空闲链表头取一个槽，否则从当前 chunk 的未使用尾部顺序取槽 - O(1)
+ * - 释放：析构节点后把槽挂回空闲链表头 - O(1)
+ * - 扩容：当前 chunk 用完时申请新的 chunk，chunk 容量按 2 倍增长直到上限
+ *
+ * 同一棵树的节点集中在少数几个连续 chunk 中，遍历和旋转时的缓存局部性更好。
+ * 内存池本身不做线程同步，由使用者保证同一时刻只有一个线程访问。
+ */
+template<typename Node>
+class NodePool {
+    // 空闲时槽位存放下一个空闲槽的指针，使用时存放节点本身
+    union Slot {
+        Slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    struct Chunk {
+        std::unique_ptr<Slot[]> slots;
+        size_t capacity;
+    };
+
+public:
+    static const size_t FIRST_CHUNK_NODES = 64;
+    static const size_t MAX_CHUNK_NODES = 64 * 1024;
+
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // 只归还 chunk 内存；仍然存活的节点应由持有它们的树先行释放
+    ~NodePool() = default;
+
+    /**
+     * 分配并构造一个节点 - 时间复杂度: O(1)
+     * 扩容时额外申请一个 chunk，平摊后仍为 O(1)
+     */
+    template<typename... Args>
+    Node* allocate(Args&&... args) {
+        Slot* slot = free_list;
+        if (slot) {
+            free_list = slot->next;
+        } else {
+            if (bump == bump_end) grow();
+            slot = bump++;
+        }
+
+        Node* n;
+        try {
+            n = ::new (static_cast<void*>(slot->storage)) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            slot->next = free_list;
+            free_list = slot;
+            throw;
+        }
+
+        ++live_nodes;
+        ++total_allocations;
+        if (live_nodes > peak_nodes) peak_nodes = live_nodes;
+        return n;
+    }
+
+    /**
+     * 析构并回收一个节点 - 时间复杂度: O(1)
+     */
+    void deallocate(Node* n) {
+        if (!n) return;
+        n->~Node();
+        Slot* slot = reinterpret_cast<Slot*>(n);
+        slot->next = free_list;
+        free_list = slot;
+        --live_nodes;
+    }
+
+    /**
+     * 批量取得 n 个地址连续、尚未构造的槽位 - 时间复杂度: O(1)
+     * 当前 chunk 剩余空间不足时，把剩余槽位挂到空闲链表，再单独申请一个恰好 n 个槽位的 chunk
+     * 第 i 个槽位为 run_slot(first, i)，调用者负责在槽位上构造节点，
+     * 构造失败的槽位用 release_unconstructed 归还
+     */
+    Node* allocate_run(size_t n) {
+        if (n == 0) return nullptr;
+        if (static_cast<size_t>(bump_end - bump) < n) {
+            while (bump != bump_end) {
+                Slot* slot = bump++;
+                slot->next = free_list;
+                free_list = slot;
+            }
+            chunks.push_back({std::unique_ptr<Slot[]>(new Slot[n]), n});
+            bump = chunks.back().slots.get();
+            bump_end = bump + n;
+            reserved_nodes += n;
+        }
+
+        Slot* first = bump;
+        bump += n;
+        live_nodes += n;
+        total_allocations += n;
+        if (live_nodes > peak_nodes) peak_nodes = live_nodes;
+        return reinterpret_cast<Node*>(first);
+    }
+
+    static Node* run_slot(Node* first, size_t i) {
+        return reinterpret_cast<Node*>(reinterpret_cast<Slot*>(first) + i);
+    }
+
+    // 归还一个从未构造过节点的槽位，不调用析构函数
+    void release_unconstructed(Node* n) {
+        Slot* slot = reinterpret_cast<Slot*>(n);
+        slot->next = free_list;
+        free_list = slot;
+        --live_nodes;
+    }
+
+    /**
+     * 归还完全空闲的 chunk - 时间复杂度: O(f log c)，f 为空闲槽数，c 为 chunk 数
+     * 仅在显式的垃圾回收时调用，不在分配路径上
+     * @return 归还的 chunk 数量
+     */
+    size_t release_unused() {
+        if (chunks.empty()) return 0;
+
+        if (live_nodes == 0) {
+            size_t released = chunks.size();
+            chunks.clear();
+            free_list = bump = bump_end = nullptr;
+            reserved_nodes = 0;
+            next_chunk_nodes = FIRST_CHUNK_NODES;
+            return released;
+        }
+
+        // 按地址排序，便于二分查找某个槽所在的 chunk
+        std::sort(chunks.begin(), chunks.end(),
+                  [](const Chunk& a, const Chunk& b) { return a.slots.get() < b.slots.get(); });
+        auto chunk_of = [this](const Slot* s) {
+            auto it = std::upper_bound(chunks.begin(), chunks.end(), s,
+                                       [](const Slot* p, const Chunk& c) { return p < c.slots.get(); });
+            return static_cast<size_t>(it - chunks.begin()) - 1;
+        };
+
+        // 统计每个 chunk 的空闲槽数，当前 chunk 未使用的尾部同样算作空闲
+        std::vector<size_t> free_count(chunks.size(), 0);
+        for (Slot* s = free_list; s; s = s->next) ++free_count[chunk_of(s)];
+        if (bump != bump_end) free_count[chunk_of(bump)] += static_cast<size_t>(bump_end - bump);
+
+        std::vector<bool> release(chunks.size(), false);
+        size_t released = 0;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            if (free_count[i] == chunks[i].capacity) {
+                release[i] = true;
+                released++;
+            }
+        }
+        if (!released) return 0;
+
+        // 重建空闲链表，跳过即将归还的 chunk 中的槽
+        Slot* rebuilt = nullptr;
+        for (Slot* s = free_list; s; ) {
+            Slot* next = s->next;
+            if (!release[chunk_of(s)]) {
+                s->next = rebuilt;
+                rebuilt = s;
+            }
+            s = next;
+        }
+        free_list = rebuilt;
+        if (bump != bump_end && release[chunk_of(bump)]) bump = bump_end = nullptr;
+
+        std::vector<Chunk> kept;
+        kept.reserve(chunks.size() - released);
+        for (size_t i = 0; i < chunks.size(); i++) {
+            if (release[i]) reserved_nodes -= chunks[i].capacity;
+            else kept.push_back(std::move(chunks[i]));
+        }
+        chunks = std::move(kept);
+        return released;
+    }
+
+    // 统计信息
+    size_t current_nodes() const { return live_nodes; }
+    size_t peak() const { return peak_nodes; }
+    size_t allocations() const { return total_allocations; }
+    size_t chunk_count() const { return chunks.size(); }
+    size_t bytes_in_use() const { return live_nodes * sizeof(Slot); }
+    size_t bytes_reserved() const { return reserved_nodes * sizeof(Slot); }
+
+private:
+    void grow() {
+        size_t capacity = next_chunk_nodes;
+        chunks.push_back({std::unique_ptr<Slot[]>(new Slot[capacity]), capacity});
+        bump = chunks.back().slots.get();
+        bump_end = bump + capacity;
+        reserved_nodes += capacity;
+        next_chunk_nodes = std::min(next_chunk_nodes * 2, MAX_CHUNK_NODES);
+    }
+
+    std::vector<Chunk> chunks;
+    Slot* free_list = nullptr;
+    Slot* bump = nullptr;       // 当前 chunk 中第一个从未使用过的槽
+    Slot* bump_end = nullptr;
+    size_t next_chunk_nodes = FIRST_CHUNK_NODES;
+    size_t reserved_nodes = 0;
+    size_t live_nodes = 0;
+    size_t peak_nodes = 0;
+    size_t total_allocations = 0;
+};
+
+template<typename Node>
+const size_t NodePool<Node>::FIRST_CHUNK_NODES;
+
+template<typename Node>
+const size_t NodePool<Node>::MAX_CHUNK_NODES;
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * 硬件性能计数器（Linux perf_event_open）
+ *
+ * 只统计本线程在用户态的事件：周期、指令、L1 数据缓存读缺失、末级缓存缺失、分支误预测。
+ * 每个事件单独打开而不组成一组，某个事件不受支持（虚拟机、ARM 上常见）时只缺这一项；
+ * 事件多于硬件计数器时内核会分时复用，读数按 启用时间 / 实际计数时间 放大。
+ * 一个也打不开时（非 Linux、内核禁止、容器内无权限）available() 为 false，调用方只报告耗时。
+ *
+ * 用法：start() 与 stop() 之间为被测阶段，stop() 返回这一段的计数 - 两者都是 O(事件数) 次系统调用
+ */
+class PerfCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+    struct Sample {
+        uint64_t value[EVENT_COUNT] = {};
+        bool valid[EVENT_COUNT] = {};
+    };
+
+    PerfCounters() {
+        for (int e = 0; e < EVENT_COUNT; e++) fds[e] = open_event(static_cast<Event>(e));
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) ::close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // 至少有一个事件可用
+    bool available() const {
+        for (int fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    bool has(Event e) const { return fds[e] >= 0; }
+
+    // 全部不可用时的原因（第一个失败事件的错误信息）
+    const std::string& error() const { return first_error; }
+
+    // 清零并开始计数
+    void start() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // 停止计数并读出 start() 以来的事件数
+    Sample stop() {
+        Sample s;
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (int e = 0; e < EVENT_COUNT; e++) {
+            if (fds[e] < 0) continue;
+            uint64_t data[3];// value, time_enabled, time_running
+            if (::read(fds[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+            s.value[e] = data[2] == data[1] ? data[0]
+                       : static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+            s.valid[e] = true;
+        }
+#endif
+        return s;
+    }
+
+    static const char* name(Event e) {
+        static const char* const names[EVENT_COUNT] = {"cycles", "instructions", "L1d-misses", "LLC-misses", "branch-misses"};
+        return names[e];
+    }
+
+private:
+    int open_event(Event e) {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        switch (e) {
+        case CYCLES: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case INSTRUCTIONS: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case LLC_MISSES: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case BRANCH_MISSES: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        default: return -1;
+        }
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;// perf_event_paranoid 为 2 时普通用户只能统计用户态
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        int fd = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0 && first_error.empty()) first_error = std::string(name(e)) + ": " + std::strerror(errno);
+        return fd;
+#else
+        (void)e;
+        if (first_error.empty()) first_error = "仅支持 Linux";
+        return -1;
+#endif
+    }
+
+    int fds[EVENT_COUNT];
+    std::string first_error;
+};
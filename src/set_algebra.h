@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * 两棵伸展树之间的集合运算：并集、交集、差集
+ *
+ * 基于拆分/连接的递归：先把较小的树重建成完全平衡的树，以它的根 k 为枢轴拆分较大的树，
+ * 左右两半分别与 k 的左右子树递归，最后以 k 为根连接（join3）或直接连接（join）。
+ * 较小的树有 m 个节点、较大的树有 n 个节点时，比较与旋转的次数为 O(m log(n/m + 1))；
+ * 两棵树的键值区间可以任意重叠。枢轴节点直接复用，不分配新节点。
+ *
+ * 两棵输入树都会被消耗，结果中不再需要的节点（重复键、交集中未匹配的部分等）被释放，
+ * 释放的代价与这些节点的个数成正比，不计入上面的界。
+ *
+ * threads > 1 时，在枢轴子树足够大的地方分出线程并行处理左半部分。两半的节点互不相交，
+ * 伸展和连接可以并发进行；但内存池不是线程安全的，所以递归过程中只把待释放的子树
+ * 记入各自的 graveyard，汇合后由调用线程统一释放。比较器抛出的异常在汇合后
+ * 传回调用者，无论哪一半先出错，都会先等另一半结束；已经从树上摘下的节点同样
+ * 记入 graveyard，异常时也全部释放，不会泄漏。
+ *
+ * Tree 需要提供 node（含 left/right/parent/key/size）、root、p_size、comp、policy、pool、split_at、join
+ * 和以游离节点为根的 join3；
+ * 两棵树必须使用同一个内存池。
+ */
+namespace set_algebra {
+
+// 枢轴子树小于该规模时不再分出线程
+const size_t PARALLEL_CUTOFF = 1 << 12;
+
+enum class op { unite, intersect, subtract };
+
+// 把 [lo, hi) 中的节点链接成完全平衡的子树，递归深度 O(log m)
+template<typename Node>
+Node* relink(std::vector<Node*>& nodes, size_t lo, size_t hi, Node* parent) {
+    if (lo >= hi) return nullptr;
+    size_t mid = lo + (hi - lo) / 2;
+    Node* x = nodes[mid];
+    x->parent = parent;
+    x->left = relink(nodes, lo, mid, x);
+    x->right = relink(nodes, mid + 1, hi, x);
+    x->size = hi - lo;
+    return x;
+}
+
+// 把以 root 为根的子树原地重建成完全平衡的树 - 时间复杂度: O(m)
+template<typename Node>
+Node* rebalance(Node* root) {
+    std::vector<Node*> nodes;
+    nodes.reserve(root ? root->size : 0);
+    // 借助 parent 指针做中序遍历
+    Node* x = root;
+    while (x && x->left) x = x->left;
+    while (x) {
+        nodes.push_back(x);
+        if (x->right) {
+            x = x->right;
+            while (x->left) x = x->left;
+        } else {
+            Node* p = x->parent;
+            while (p && x == p->right) {
+                x = p;
+                p = p->parent;
+            }
+            x = p;
+        }
+    }
+    return relink(nodes, 0, nodes.size(), static_cast<Node*>(nullptr));
+}
+
+/**
+ * big 为被拆分的树，p 为来自较小树的枢轴子树（已平衡）
+ * pivot_left 表示枢轴子树来自左操作数，只有差集需要区分
+ */
+template<typename Tree>
+Tree combine(op o, bool pivot_left, Tree&& big, typename Tree::node* p, unsigned threads,
+             std::vector<typename Tree::node*>& graveyard) {
+    using node = typename Tree::node;
+
+    // 一侧为空：并集保留另一侧；差集只保留左操作数；交集全部丢弃
+    if (!p || !big.root) {
+        bool keep_big = o == op::unite || (o == op::subtract && !pivot_left);
+        bool keep_pivot = o == op::unite || (o == op::subtract && pivot_left);
+        Tree result(*big.pool);
+        result.comp = big.comp;
+        result.policy = big.policy;
+        if (big.root) {
+            if (keep_big) result = std::move(big);
+            else graveyard.push_back(big.root);
+            big.root = nullptr;
+            big.p_size = 0;
+        }
+        if (p) {
+            p->parent = nullptr;
+            if (keep_pivot) {
+                result.root = p;
+                result.p_size = p->size;
+            } else {
+                graveyard.push_back(p);
+            }
+        }
+        return result;
+    }
+
+    // 摘下枢轴，按它的键拆分 big
+    node* pl = p->left;
+    node* pr = p->right;
+    p->left = p->right = p->parent = nullptr;
+    p->size = 1;
+    if (pl) pl->parent = nullptr;
+    if (pr) pr->parent = nullptr;
+
+    // 比较器抛出异常时，已摘下但还没交给递归的节点（枢轴、重复键、未处理的枢轴子树）
+    // 不属于任何树，记入 graveyard 由 apply 释放；交给递归的部分由递归自己负责
+    node* dup = nullptr;
+    bool left_taken = false, right_taken = false;
+    Tree left, right;
+    try {
+        auto [l, r] = big.split_at(p->key);
+
+        // 键存在时拆分后它就是左树的根，且没有右孩子
+        if (l.root && !l.comp(l.root->key, p->key)) {
+            dup = l.root;
+            l.root = dup->left;
+            if (l.root) l.root->parent = nullptr;
+            l.p_size--;
+            dup->left = nullptr;
+            dup->size = 1;
+        }
+
+        bool forked = false;
+        if (threads > 1 && pl && pl->size > PARALLEL_CUTOFF) {
+            std::vector<node*> left_graveyard;
+            std::exception_ptr left_error;
+            std::thread worker;
+            try {
+                worker = std::thread([&] {
+                    try {
+                        left = combine(o, pivot_left, std::move(l), pl, threads / 2, left_graveyard);
+                    } catch (...) {
+                        left_error = std::current_exception();
+                    }
+                });
+                forked = left_taken = true;
+            } catch (const std::system_error&) {
+                // 无法创建线程时退回单线程递归
+            }
+            if (forked) {
+                // 本线程的递归抛出异常时同样要先等工作线程结束（否则 std::thread 析构时程序终止），
+                // 并把它记下的待释放子树并入 graveyard
+                right_taken = true;
+                try {
+                    right = combine(o, pivot_left, std::move(r), pr, threads - threads / 2, graveyard);
+                } catch (...) {
+                    worker.join();
+                    graveyard.insert(graveyard.end(), left_graveyard.begin(), left_graveyard.end());
+                    throw;
+                }
+                worker.join();
+            }
+            graveyard.insert(graveyard.end(), left_graveyard.begin(), left_graveyard.end());
+            if (left_error) std::rethrow_exception(left_error);
+        }
+        if (!forked) {
+            left_taken = true;
+            left = combine(o, pivot_left, std::move(l), pl, 1u, graveyard);
+            right_taken = true;
+            right = combine(o, pivot_left, std::move(r), pr, 1u, graveyard);
+        }
+    } catch (...) {
+        graveyard.push_back(p);
+        if (dup) graveyard.push_back(dup);
+        if (pl && !left_taken) graveyard.push_back(pl);
+        if (pr && !right_taken) graveyard.push_back(pr);
+        throw;
+    }
+
+    // 枢轴键是否出现在结果中；出现时保留枢轴节点，重复的那个释放
+    bool keep;
+    switch (o) {
+        case op::unite: keep = true; break;
+        case op::intersect: keep = dup != nullptr; break;
+        default: keep = pivot_left && !dup; break;
+    }
+    if (dup) graveyard.push_back(dup);
+    if (keep) return Tree::join3(std::move(left), p, std::move(right));
+    graveyard.push_back(p);
+    return Tree::join(std::move(left), std::move(right));
+}
+
+/**
+ * 计算 a op b，消耗两棵输入树 - 时间复杂度: O(m log(n/m + 1))
+ * threads 为 0 表示使用全部硬件线程
+ */
+template<typename Tree>
+Tree apply(op o, Tree&& a, Tree&& b, unsigned threads = 1) {
+    using node = typename Tree::node;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    bool pivot_left = a.p_size < b.p_size;
+    Tree& small = pivot_left ? a : b;
+    Tree& big = pivot_left ? b : a;
+
+    // 平衡的枢轴树保证递归深度为 O(log m)
+    node* p = rebalance(small.root);
+    small.root = nullptr;
+    small.p_size = 0;
+
+    std::vector<node*> graveyard;
+    try {
+        Tree result = combine(o, pivot_left, std::move(big), p, threads, graveyard);
+        for (node* x : graveyard) result.clear(x);
+        return result;
+    } catch (...) {
+        // 记入 graveyard 的子树已经不属于任何树，异常时也要释放
+        for (node* x : graveyard) small.clear(x);
+        throw;
+    }
+}
+
+} // namespace set_algebra
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include "node_pool.h"
+#include "splay_tree.h"
+
+/**
+ * 分片并发伸展树
+ *
+ * 伸展树的查找也会旋转，单棵树无法让多个线程同时读。这里按键把数据划分到 N 棵
+ * 互相独立的伸展树（分片）上，每个分片有自己的锁和自己的节点内存池：
+ * - 不同分片上的操作完全并行，只有落到同一分片的操作才互斥
+ * - 各分片的内存池互不共享，分配和释放不需要额外同步
+ * - 分片按缓存行对齐，避免相邻分片的锁和根指针产生伪共享
+ *
+ * Partitioner 决定键属于哪个分片：
+ * - HashPartitioner：按哈希划分，负载均匀，导出有序序列时需要多路归并
+ * - RangePartitioner：按给定的分界点划分，分片之间本身有序，导出时直接依次拼接
+ */
+
+// 按哈希划分：先做一次乘法散列，避免 std::hash 对整数是恒等映射时低位分布不均
+template<typename T, typename Hash = std::hash<T>>
+struct HashPartitioner {
+    static constexpr bool ordered = false;
+    Hash hash;
+
+    size_t operator()(const T& key, size_t shards) const {
+        uint64_t h = static_cast<uint64_t>(hash(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>((h >> 32) % shards);
+    }
+};
+
+// 按键值区间划分：bounds 为升序的分界点，第 i 个分片包含 [bounds[i-1], bounds[i]) 中的键
+template<typename T, typename Comp = std::less<T>>
+struct RangePartitioner {
+    static constexpr bool ordered = true;
+    std::vector<T> bounds;
+    Comp comp;
+
+    RangePartitioner() = default;
+    explicit RangePartitioner(std::vector<T> b, Comp c = Comp()) : bounds(std::move(b)), comp(c) {}
+
+    size_t operator()(const T& key, size_t shards) const {
+        size_t i = std::upper_bound(bounds.begin(), bounds.end(), key, comp) - bounds.begin();
+        return std::min(i, shards - 1);
+    }
+};
+
+template<typename T, typename Comp = std::less<T>, typename Partitioner = HashPartitioner<T>,
+         typename SplayPolicy = FullSplay>
+class ShardedSplayTree {
+public:
+    using tree_type = SplayTree<T, Comp, SplayPolicy>;
+    using node = typename tree_type::node;
+
+private:
+    struct alignas(64) shard {
+        std::mutex lock;
+        NodePool<node> pool;
+        tree_type tree;// 声明在 pool 之后，析构时先于内存池释放节点
+
+        shard() : tree(pool) {}
+    };
+
+    Partitioner partitioner;
+    size_t shard_count;
+    std::unique_ptr<shard[]> shards;
+
+    shard& shard_of(const T& key) { return shards[partitioner(key, shard_count)]; }
+
+public:
+    /**
+     * 创建 shard_count 个分片，RangePartitioner 的分界点个数应为 shard_count - 1
+     * 分片数通常取线程数的 2~4 倍，以降低热点分片上的锁竞争
+     */
+    explicit ShardedSplayTree(size_t count, Partitioner p = Partitioner())
+        : partitioner(std::move(p)), shard_count(std::max<size_t>(1, count)),
+          shards(new shard[shard_count]) {}
+
+    ShardedSplayTree(const ShardedSplayTree&) = delete;
+    ShardedSplayTree& operator=(const ShardedSplayTree&) = delete;
+
+    // 插入 - 时间复杂度: 平摊 O(log(n/N))，只锁键所在的分片
+    void insert(const T& key) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> guard(s.lock);
+        s.tree.insert(key);
+    }
+
+    /**
+     * 插入或更新 - 时间复杂度: 平摊 O(log(n/N))
+     * 在分片锁内对 key 所在节点的键调用 f（新插入或已存在）。
+     * f 只能修改不参与比较的字段，例如与单词一起存放的计数
+     */
+    template<typename F>
+    void upsert(const T& key, F&& f) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> guard(s.lock);
+        f(s.tree.insert(key)->key);
+    }
+
+    // 是否包含 key - 时间复杂度: 平摊 O(log(n/N))；查找会伸展，所以同样需要加锁
+    bool contains(const T& key) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> guard(s.lock);
+        return s.tree.find(key) != nullptr;
+    }
+
+    /**
+     * 查找并把键复制到 out - 时间复杂度: 平摊 O(log(n/N))
+     * 节点可能在解锁后被其他线程删除，因此不返回节点指针
+     */
+    bool find(const T& key, T& out) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> guard(s.lock);
+        node* x = s.tree.find(key);
+        if (!x) return false;
+        out = x->key;
+        return true;
+    }
+
+    // 删除 - 时间复杂度: 平摊 O(log(n/N))
+    void erase(const T& key) {
+        shard& s = shard_of(key);
+        std::lock_guard<std::mutex> guard(s.lock);
+        s.tree.erase(key);
+    }
+
+    // 总键数 - O(N)，依次锁住每个分片读取，不是全局一致的快照
+    size_t size() {
+        size_t total = 0;
+        for (size_t i = 0; i < shard_count; i++) {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            total += shards[i].tree.size();
+        }
+        return total;
+    }
+
+    size_t shards_size() const { return shard_count; }
+
+    // 各分片节点内存池占用的字节数之和
+    size_t bytes_in_use() {
+        size_t total = 0;
+        for (size_t i = 0; i < shard_count; i++) {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            total += shards[i].pool.bytes_in_use();
+        }
+        return total;
+    }
+
+    /**
+     * 按键值升序对所有键调用 f - 时间复杂度: 区间划分 O(n)，哈希划分 O(n log N)
+     * 导出期间锁住全部分片（按下标顺序加锁，不会与其他导出互相死锁），得到一致的快照
+     */
+    template<typename F>
+    void for_each_sorted(F&& f) {
+        std::vector<std::unique_lock<std::mutex>> guards;
+        guards.reserve(shard_count);
+        for (size_t i = 0; i < shard_count; i++) guards.emplace_back(shards[i].lock);
+
+        if constexpr (Partitioner::ordered) {
+            for (size_t i = 0; i < shard_count; i++) {
+                for (const T& key : shards[i].tree) f(key);
+            }
+        } else {
+            // 多路归并：堆中保存每个分片当前的迭代位置
+            using iter = typename tree_type::const_iterator;
+            struct cursor { iter it, end; };
+            Comp comp;
+            auto later = [&comp](const cursor& a, const cursor& b) { return comp(*b.it, *a.it); };
+            std::priority_queue<cursor, std::vector<cursor>, decltype(later)> heap(later);
+            for (size_t i = 0; i < shard_count; i++) {
+                if (shards[i].tree.root) heap.push({shards[i].tree.begin(), shards[i].tree.end()});
+            }
+            while (!heap.empty()) {
+                cursor c = heap.top();
+                heap.pop();
+                f(*c.it);
+                if (++c.it != c.end) heap.push(c);
+            }
+        }
+    }
+
+    // 导出全部键的升序序列
+    std::vector<T> export_sorted() {
+        std::vector<T> result;
+        for_each_sorted([&result](const T& key) { result.push_back(key); });
+        return result;
+    }
+};
@@ -0,0 +1,460 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <cmath>
+#include <thread>
+#include "splay_tree.h"
+#include <mutex>
+#include "compact_splay_tree.h"
+#include "sharded_splay_tree.h"
+#include "top_down_splay_tree.h"
+#include "zipf_generator.h"
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * 通用伸展树性能测试程序
+ *
+ * 用法: splay_benchmark [测试项] [节点数]
+ *   storage  指针存储模式与紧凑下标存储模式的对比（随机访问 / 倾斜访问）
+ *   engine   自底向上伸展与自顶向下伸展的对比
+ *   policy   不同伸展策略的对比
+ *   split    拆分+合并一轮的耗时随规模的变化（规模从 1000 按 10 倍增长到节点数）
+ *   build    逐个插入与由有序输入线性时间批量构建（单线程 / 多线程）的对比
+ *   range    区间扫描（lower_bound + 迭代器）以及区间删除与逐个删除的对比
+ *   setops   集合运算（union/inter/diff）与逐个插入/删除的对比，较小的树为节点数的 1/10，键值区间部分重叠
+ *   sharded  多线程插入/查找：单棵树加全局锁与分片树的吞吐量随线程数的变化
+ *   stress   有序插入得到退化成链的树（默认 1000 万节点），测量复制和析构的吞吐量
+ */
+
+template<typename F>
+double measureNs(F&& f) {
+    auto start = high_resolution_clock::now();
+    f();
+    auto end = high_resolution_clock::now();
+    return double(duration_cast<nanoseconds>(end - start).count());
+}
+
+// 打乱顺序的 n 个键，以及均匀分布和 Zipf(1) 分布的两组查找序列
+struct Workload {
+    vector<int> keys;
+    vector<int> randomProbe;
+    vector<int> skewedProbe;
+};
+
+Workload makeWorkload(size_t n, unsigned seed) {
+    mt19937 gen(seed);
+    Workload w;
+    w.keys.resize(n);
+    for (size_t i = 0; i < n; i++) w.keys[i] = int(i);
+    shuffle(w.keys.begin(), w.keys.end(), gen);
+
+    w.randomProbe.resize(n);
+    w.skewedProbe.resize(n);
+    uniform_int_distribution<size_t> uniform(0, n - 1);
+    ZipfGenerator zipf(n, 1.0);
+    for (size_t i = 0; i < n; i++) {
+        w.randomProbe[i] = w.keys[uniform(gen)];
+        w.skewedProbe[i] = w.keys[zipf(gen)];
+    }
+    return w;
+}
+
+struct StorageResult {
+    double insertNs;
+    double randomFindNs;
+    double skewedFindNs;
+    double bytesPerNode;
+};
+
+template<typename Tree, typename BytesFn>
+StorageResult runStorage(const Workload& w, BytesFn bytesOf) {
+    StorageResult r;
+    Tree tree;
+    r.insertNs = measureNs([&] { for (int k : w.keys) tree.insert(k); }) / w.keys.size();
+    r.bytesPerNode = double(bytesOf(tree)) / tree.size();
+
+    size_t found = 0;
+    r.randomFindNs = measureNs([&] {
+        for (int k : w.randomProbe) found += tree.find(k) != nullptr;
+    }) / w.randomProbe.size();
+    r.skewedFindNs = measureNs([&] {
+        for (int k : w.skewedProbe) found += tree.find(k) != nullptr;
+    }) / w.skewedProbe.size();
+
+    if (found != w.randomProbe.size() + w.skewedProbe.size()) {
+        cout << "Error: 查找结果不完整" << endl;
+    }
+    return r;
+}
+
+void printStorageRow(const char* name, const StorageResult& r) {
+    cout << name << "\t" << r.insertNs << "\t\t" << r.randomFindNs << "\t\t"
+         << r.skewedFindNs << "\t\t" << r.bytesPerNode << endl;
+}
+
+void benchStorage(size_t n) {
+    Workload w = makeWorkload(n, 42);
+
+    using PointerTree = SplayTree<int>;
+    using IndexTree = CompactSplayTree<int>;
+
+    auto pointerResult = runStorage<PointerTree>(w,
+        [](const PointerTree&) { return PointerTree::get_bytes_reserved(); });
+    PointerTree::cleanup_unused();
+    auto compactResult = runStorage<IndexTree>(w,
+        [](const IndexTree& t) { return t.bytes_reserved(); });
+
+    cout << "=== 存储模式对比 (n = " << n << ") ===" << endl;
+    cout << "节点大小: 指针模式 " << sizeof(PointerTree::node) << " 字节, "
+         << "紧凑模式 " << sizeof(IndexTree::node) << " 字节" << endl;
+    cout << "模式\t\t插入(ns)\t随机查找(ns)\t倾斜查找(ns)\t字节/节点" << endl;
+    cout << fixed << setprecision(1);
+    printStorageRow("pointer", pointerResult);
+    printStorageRow("compact", compactResult);
+}
+
+void benchEngine(size_t n) {
+    Workload w = makeWorkload(n, 7);
+
+    using BottomUpTree = SplayTree<int>;
+    using TopDownTree = TopDownSplayTree<int>;
+
+    auto bottomUp = runStorage<BottomUpTree>(w,
+        [](const BottomUpTree&) { return BottomUpTree::get_bytes_in_use(); });
+    BottomUpTree::cleanup_unused();
+    auto topDown = runStorage<TopDownTree>(w,
+        [](const TopDownTree&) { return TopDownTree::get_bytes_in_use(); });
+
+    cout << "=== 伸展引擎对比 (n = " << n << ") ===" << endl;
+    cout << "引擎\t\t插入(ns)\t随机查找(ns)\t倾斜查找(ns)\t字节/节点" << endl;
+    cout << fixed << setprecision(1);
+    printStorageRow("bottom-up", bottomUp);
+    printStorageRow("top-down", topDown);
+}
+
+template<typename Policy>
+void runPolicy(const char* name, const Workload& w) {
+    using Tree = SplayTree<int, less<int>, Policy>;
+    auto r = runStorage<Tree>(w,
+        [](const Tree&) { return Tree::get_bytes_in_use(); });
+    Tree::cleanup_unused();
+    printStorageRow(name, r);
+}
+
+void benchPolicy(size_t n) {
+    Workload w = makeWorkload(n, 11);
+
+    cout << "=== 伸展策略对比 (n = " << n << ") ===" << endl;
+    cout << "策略\t\t插入(ns)\t随机查找(ns)\t倾斜查找(ns)\t字节/节点" << endl;
+    cout << fixed << setprecision(1);
+    runPolicy<FullSplay>("full", w);
+    runPolicy<SemiSplay>("semi", w);
+    runPolicy<DepthThresholdSplay<32>>("depth>32", w);
+    runPolicy<RandomizedSplay<100>>("random10%", w);
+    runPolicy<PeriodicSplay<100>>("every100", w);
+}
+
+void benchSplit(size_t n) {
+    using Tree = SplayTree<int>;
+    const int CYCLES = 10000;
+
+    cout << "=== 拆分/合并耗时 ===" << endl;
+    cout << "节点数\t\t指针接口(ns)\t按值接口(ns)\t左树大小校验" << endl;
+    cout << fixed << setprecision(1);
+    for (size_t size = 1000; size <= n; size *= 10) {
+        Workload w = makeWorkload(size, 3);
+        Tree* tree = new Tree();
+        for (int k : w.keys) tree->insert(k);
+
+        mt19937 gen(5);
+        uniform_int_distribution<int> pick(0, int(size) - 1);
+        bool sizesOk = true;
+
+        // split 返回两棵新分配的树，merge 接管并释放它们
+        double pointerNs = measureNs([&] {
+            for (int i = 0; i < CYCLES; i++) {
+                int key = pick(gen);
+                auto [left, right] = tree->split(key);
+                sizesOk &= left->size() == size_t(key) + 1;
+                delete tree;
+                tree = Tree::merge(left, right);
+            }
+        }) / CYCLES;
+
+        // split_at/join 通过移动传递树，不分配树对象
+        Tree value(std::move(*tree));
+        delete tree;
+        double valueNs = measureNs([&] {
+            for (int i = 0; i < CYCLES; i++) {
+                int key = pick(gen);
+                auto [left, right] = value.split_at(key);
+                sizesOk &= left.size() == size_t(key) + 1;
+                value = Tree::join(std::move(left), std::move(right));
+            }
+        }) / CYCLES;
+
+        cout << size << "\t\t" << pointerNs << "\t\t" << valueNs << "\t\t"
+             << (sizesOk ? "通过" : "失败") << endl;
+    }
+}
+
+void benchBuild(size_t n) {
+    using Tree = SplayTree<int>;
+    vector<int> sorted(n);
+    for (size_t i = 0; i < n; i++) sorted[i] = int(i);
+    unsigned threads = max(1u, thread::hardware_concurrency());
+
+    cout << "=== 批量构建对比 (n = " << n << ", 线程数 " << threads << ") ===" << endl;
+    cout << "方式		总耗时(ms)	每节点(ns)	树高" << endl;
+    cout << fixed << setprecision(1);
+
+    auto report = [&](const char* name, auto&& build) {
+        Tree tree;
+        double ns = measureNs([&] { build(tree); });
+        // 逐层统计高度，不改变树的形状
+        size_t height = 0;
+        vector<Tree::node*> level;
+        if (tree.root) level.push_back(tree.root);
+        while (!level.empty()) {
+            vector<Tree::node*> next;
+            for (auto* x : level) {
+                if (x->left) next.push_back(x->left);
+                if (x->right) next.push_back(x->right);
+            }
+            level.swap(next);
+            height++;
+        }
+        cout << name << "\t" << ns / 1e6 << "\t\t" << ns / n << "\t\t" << height << endl;
+        tree.clear(tree.root);
+        tree.root = nullptr;
+        Tree::cleanup_unused();
+    };
+
+    // 逐个插入使用打乱后的顺序：有序插入会把树压成一条链
+    vector<int> shuffled = sorted;
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(13));
+    report("insert", [&](Tree& t) { for (int k : shuffled) t.insert(k); });
+    report("bulk x1", [&](Tree& t) { t.build_from_sorted(sorted.begin(), sorted.end()); });
+    report("bulk xN", [&](Tree& t) { t.build_from_sorted(sorted.begin(), sorted.end(), threads); });
+}
+
+void benchRange(size_t n) {
+    using Tree = SplayTree<int>;
+    const int ROUNDS = 1000;
+    const int WIDTH = 100;
+    Workload w = makeWorkload(n, 17);
+
+    cout << "=== 区间操作 (n = " << n << ", 区间宽度 " << WIDTH << ") ===" << endl;
+    cout << "操作\t\t每个区间(ns)\t校验" << endl;
+    cout << fixed << setprecision(1);
+
+    // 区间扫描：不物化任何中间结果
+    {
+        Tree tree;
+        for (int k : w.keys) tree.insert(k);
+        mt19937 gen(19);
+        uniform_int_distribution<int> pick(0, int(n) - WIDTH);
+        long long sum = 0, expected = 0;
+        double ns = measureNs([&] {
+            for (int i = 0; i < ROUNDS; i++) {
+                int lo = pick(gen);
+                for (auto it = tree.lower_bound(lo); it != tree.end() && *it < lo + WIDTH; ++it) sum += *it;
+                expected += (long long)WIDTH * lo + WIDTH * (WIDTH - 1) / 2;
+            }
+        }) / ROUNDS;
+        cout << "scan\t\t" << ns << "\t\t" << (sum == expected ? "通过" : "失败") << endl;
+    }
+
+    // 区间删除：两棵相同的树分别按区间整体删除和逐个键删除，删除的窗口相同
+    Tree byRange, byKey;
+    for (int k : w.keys) {
+        byRange.insert(k);
+        byKey.insert(k);
+    }
+    vector<int> starts(ROUNDS);
+    mt19937 gen(23);
+    uniform_int_distribution<int> pick(0, int(n) - WIDTH);
+    for (auto& lo : starts) lo = pick(gen);
+
+    double rangeNs = measureNs([&] {
+        for (int lo : starts) byRange.erase(byRange.lower_bound(lo), byRange.lower_bound(lo + WIDTH));
+    }) / ROUNDS;
+    double keyNs = measureNs([&] {
+        for (int lo : starts) {
+            for (int k = lo; k < lo + WIDTH; k++) byKey.erase(k);
+        }
+    }) / ROUNDS;
+    bool same = byRange.size() == byKey.size() && equal(byRange.begin(), byRange.end(), byKey.begin());
+    cout << "erase range\t" << rangeNs << "\t\t" << (same ? "通过" : "失败") << endl;
+    cout << "erase keys\t" << keyNs << endl;
+}
+
+void benchSetOps(size_t n) {
+    using Tree = SplayTree<int>;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    size_t m = max<size_t>(1, n / 10);
+
+    // 两组随机键：大树取自 [0, 2n)，小树取自 [n, 3n)，约有一半的区间重叠
+    mt19937 gen(29);
+    vector<int> bigKeys(n), smallKeys(m);
+    for (auto& k : bigKeys) k = int(gen() % (2 * n));
+    for (auto& k : smallKeys) k = int(n + gen() % (2 * n));
+    auto build = [](const vector<int>& keys) {
+        Tree t;
+        for (int k : keys) t.insert(k);
+        return t;
+    };
+
+    cout << "=== 集合运算 (n = " << n << ", m = " << m << ", 线程数 " << threads << ") ===" << endl;
+    cout << "运算\t\t逐个操作(ms)\t拆分/连接(ms)\t并行(ms)\t结果大小" << endl;
+    cout << fixed << setprecision(1);
+
+    auto report = [&](const char* name, auto naive, auto bulk) {
+        Tree a = build(bigKeys), b = build(smallKeys);
+        double naiveNs = measureNs([&] { naive(a, b); });
+        size_t expected = a.size();
+        vector<int> expectedKeys(a.begin(), a.end());
+
+        Tree c = build(bigKeys), d = build(smallKeys), r1;
+        double bulkNs = measureNs([&] { r1 = bulk(std::move(c), std::move(d), 1u); });
+        Tree e = build(bigKeys), f = build(smallKeys), rN;
+        double parallelNs = measureNs([&] { rN = bulk(std::move(e), std::move(f), threads); });
+
+        bool ok = r1.size() == expected && rN.size() == expected &&
+                  equal(r1.begin(), r1.end(), expectedKeys.begin()) &&
+                  equal(rN.begin(), rN.end(), expectedKeys.begin());
+        cout << name << "\t\t" << naiveNs / 1e6 << "\t\t" << bulkNs / 1e6 << "\t\t"
+             << parallelNs / 1e6 << "\t\t" << expected << (ok ? "" : " 失败") << endl;
+    };
+
+    report("union",
+        [&](Tree& a, Tree& b) { for (int k : b) a.insert(k); },
+        [](Tree&& a, Tree&& b, unsigned t) { return Tree::set_union(std::move(a), std::move(b), t); });
+    report("inter",
+        [&](Tree& a, Tree& b) {
+            // 逐个查找 a 中的键，保留在 b 中出现的
+            vector<int> keep;
+            for (int k : b) if (a.find(k)) keep.push_back(k);
+            a = Tree();
+            for (int k : keep) a.insert(k);
+        },
+        [](Tree&& a, Tree&& b, unsigned t) { return Tree::set_intersection(std::move(a), std::move(b), t); });
+    report("diff",
+        [&](Tree& a, Tree& b) { for (int k : b) a.erase(k); },
+        [](Tree&& a, Tree&& b, unsigned t) { return Tree::set_difference(std::move(a), std::move(b), t); });
+}
+
+// 每个线程处理 ops 中属于自己的一段，返回总耗时（纳秒）
+template<typename F>
+double runThreads(unsigned threads, F&& work) {
+    return measureNs([&] {
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; t++) workers.emplace_back(work, t);
+        for (auto& w : workers) w.join();
+    });
+}
+
+void benchSharded(size_t n) {
+    // 一半插入一半查找，键服从 Zipf(1) 分布，模拟词频统计中的热点词
+    Workload w = makeWorkload(n, 31);
+    const vector<int>& ops = w.skewedProbe;
+    unsigned maxThreads = max(1u, thread::hardware_concurrency());
+
+    cout << "=== 分片并发树 (n = " << n << ", 硬件线程 " << maxThreads << ") ===" << endl;
+    cout << "线程数\t全局锁(百万次/秒)\t分片(百万次/秒)\t分片数\t校验" << endl;
+    cout << fixed << setprecision(2);
+
+    for (unsigned threads = 1; threads <= max(4u, maxThreads); threads *= 2) {
+        auto slice = [&](unsigned t) {
+            return make_pair(n * t / threads, n * (t + 1) / threads);
+        };
+
+        SplayTree<int> single;
+        mutex singleLock;
+        double singleNs = runThreads(threads, [&](unsigned t) {
+            auto [lo, hi] = slice(t);
+            for (size_t i = lo; i < hi; i++) {
+                lock_guard<mutex> guard(singleLock);
+                if (i & 1) single.find(ops[i]);
+                else single.insert(ops[i]);
+            }
+        });
+
+        size_t shardCount = 4 * size_t(threads);
+        ShardedSplayTree<int> sharded(shardCount);
+        double shardedNs = runThreads(threads, [&](unsigned t) {
+            auto [lo, hi] = slice(t);
+            for (size_t i = lo; i < hi; i++) {
+                if (i & 1) sharded.contains(ops[i]);
+                else sharded.insert(ops[i]);
+            }
+        });
+
+        bool same = sharded.size() == single.size() &&
+                    sharded.export_sorted() == vector<int>(single.begin(), single.end());
+        cout << threads << "\t" << n / (singleNs / 1e3) << "\t\t\t" << n / (shardedNs / 1e3)
+             << "\t\t\t" << shardCount << "\t" << (same ? "通过" : "失败") << endl;
+    }
+}
+
+// 有序插入后每个新节点都被伸展到根，原根成为其左孩子，整棵树退化成一条左链
+template<typename Tree>
+void runStress(const char* name, size_t n) {
+    auto tree = make_unique<Tree>();
+    double buildNs = measureNs([&] { for (size_t i = 0; i < n; i++) tree->insert(int(i)); });
+
+    unique_ptr<Tree> copy;
+    double copyNs = measureNs([&] { copy = make_unique<Tree>(*tree); });
+    bool sizeOk = copy->size() == n;
+    double copyDestroyNs = measureNs([&] { copy.reset(); });
+    double destroyNs = measureNs([&] { tree.reset(); });
+
+    cout << name << "\t" << buildNs / 1e6 << "\t\t" << n / (copyNs / 1e9) / 1e6 << "\t\t"
+         << n / ((destroyNs + copyDestroyNs) / 2 / 1e9) / 1e6 << "\t\t"
+         << (sizeOk ? "通过" : "失败") << endl;
+}
+
+void benchStress(size_t n) {
+    cout << "=== 退化树压力测试 (n = " << n << ") ===" << endl;
+    cout << "实现		建树(ms)	复制(百万节点/秒)	析构(百万节点/秒)	大小校验" << endl;
+    cout << fixed << setprecision(1);
+    runStress<SplayTree<int>>("pointer", n);
+    SplayTree<int>::cleanup_unused();
+    runStress<CompactSplayTree<int>>("compact", n);
+    runStress<TopDownSplayTree<int>>("top-down", n);
+}
+
+int main(int argc, char* argv[]) {
+    string test = argc > 1 ? argv[1] : "storage";
+    size_t n = argc > 2 ? stoul(argv[2]) : test == "stress" ? 10000000 : 1000000;
+
+    if (test == "storage") {
+        benchStorage(n);
+    } else if (test == "engine") {
+        benchEngine(n);
+    } else if (test == "policy") {
+        benchPolicy(n);
+    } else if (test == "split") {
+        benchSplit(n);
+    } else if (test == "build") {
+        benchBuild(n);
+    } else if (test == "range") {
+        benchRange(n);
+    } else if (test == "setops") {
+        benchSetOps(n);
+    } else if (test == "sharded") {
+        benchSharded(n);
+    } else if (test == "stress") {
+        benchStress(n);
+    } else {
+        cout << "未知测试项: " << test << endl;
+        return 1;
+    }
+    return 0;
+}
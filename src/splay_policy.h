@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 伸展策略
+ *
+ * 作为伸展树的模板参数，在编译期决定一次访问之后是否伸展以及如何伸展：
+ * - should_splay(depth)：本次访问的节点深度为 depth 时是否需要伸展
+ * - semi：为 true 时使用半伸展（zig-zig 情况只旋转一次，被访问节点只上移到路径的一半左右）
+ *
+ * FullSplay 的 should_splay 恒为 true，内联后不会在热路径上留下任何分支。
+ * 删除、拆分、合并依赖目标位于根部，这些操作始终完全伸展，不受策略影响。
+ */
+
+// 每次访问都完全伸展到根（经典伸展树）
+struct FullSplay {
+    static constexpr bool semi = false;
+    constexpr bool should_splay(size_t) const { return true; }
+};
+
+// 每次访问都半伸展，旋转次数约为完全伸展的一半，局部性略弱
+struct SemiSplay {
+    static constexpr bool semi = true;
+    constexpr bool should_splay(size_t) const { return true; }
+};
+
+// 只有访问深度超过 Bound 时才伸展，浅层节点的访问不改变树的结构
+template<size_t Bound>
+struct DepthThresholdSplay {
+    static constexpr bool semi = false;
+    constexpr bool should_splay(size_t depth) const { return depth > Bound; }
+};
+
+// 以 Permille / 1000 的概率伸展，使用 xorshift 生成随机数，每棵树各自持有状态
+template<unsigned Permille>
+struct RandomizedSplay {
+    static_assert(Permille <= 1000, "概率必须在 0 到 1000 之间");
+    static constexpr bool semi = false;
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    bool should_splay(size_t) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        // 取高 32 位映射到 [0, 1000)，避免取模
+        return ((state >> 32) * 1000) >> 32 < Permille;
+    }
+};
+
+// 每 Period 次访问伸展一次，即词频统计中原有的条件伸展
+template<unsigned Period>
+struct PeriodicSplay {
+    static_assert(Period > 0, "伸展周期必须大于 0");
+    static constexpr bool semi = false;
+
+    unsigned counter = 0;
+
+    bool should_splay(size_t) {
+        if (++counter < Period) return false;
+        counter = 0;
+        return true;
+    }
+};
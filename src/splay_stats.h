@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 伸展树的统计策略
+ *
+ * 作为伸展树的模板参数，在编译期决定是否收集统计信息，树在以下位置调用对应的钩子：
+ * - rotation()：每次单旋转；zig() / zig_zig() / zig_zag()：伸展的每一步属于哪种情况
+ *   （半伸展的 zig-zig 只旋转一次，仍记为一次 zig_zig）
+ * - comparison()：查找路径上的每次键比较
+ * - access()：每次插入或查找
+ * - allocation(n)：新建 n 个节点（批量构建时一次报告）
+ * - splay_path(length)：一次伸展结束，length 为被伸展节点原来的深度
+ *
+ * NoStats 的钩子全部为空，内联后不留下任何指令；CountingStats 用 64 位计数，不会溢出。
+ * 不指定时由宏 SPLAY_TREE_STATS 决定默认策略：定义为 1 时统计，否则不统计。
+ */
+
+#ifndef SPLAY_TREE_STATS
+#define SPLAY_TREE_STATS 0
+#endif
+
+// 不统计，所有钩子都是空函数
+struct NoStats {
+    static constexpr bool enabled = false;
+    void rotation() {}
+    void zig() {}
+    void zig_zig() {}
+    void zig_zag() {}
+    void comparison() {}
+    void access() {}
+    void allocation(size_t = 1) {}
+    void splay_path(size_t) {}
+    void reset() {}
+};
+
+// 统计旋转、比较、访问、分配的次数，以及伸展路径长度的分布
+struct CountingStats {
+    static constexpr bool enabled = true;
+    static constexpr size_t PATH_BUCKETS = 64;  // 路径长度直方图的桶数，不短于 PATH_BUCKETS - 1 的归入最后一桶
+
+    uint64_t rotations = 0;
+    uint64_t zigs = 0;
+    uint64_t zig_zigs = 0;
+    uint64_t zig_zags = 0;
+    uint64_t comparisons = 0;
+    uint64_t accesses = 0;
+    uint64_t allocations = 0;
+    uint64_t splays = 0;
+    uint64_t path_total = 0;
+    uint64_t longest_path = 0;
+    uint64_t path_lengths[PATH_BUCKETS] = {};
+
+    void rotation() { rotations++; }
+    void zig() { zigs++; }
+    void zig_zig() { zig_zigs++; }
+    void zig_zag() { zig_zags++; }
+    void comparison() { comparisons++; }
+    void access() { accesses++; }
+    void allocation(size_t n = 1) { allocations += n; }
+
+    void splay_path(size_t length) {
+        splays++;
+        path_total += length;
+        if (length > longest_path) longest_path = length;
+        path_lengths[length < PATH_BUCKETS ? length : PATH_BUCKETS - 1]++;
+    }
+
+    void reset() { *this = CountingStats(); }
+
+    double average_path() const { return splays ? static_cast<double>(path_total) / splays : 0.0; }
+
+    // 第 p 百分位的伸展路径长度（0 < p <= 100），落在最后一桶时返回 PATH_BUCKETS - 1
+    size_t path_percentile(double p) const {
+        uint64_t target = static_cast<uint64_t>(p / 100.0 * static_cast<double>(splays) + 0.999999);
+        if (target == 0) target = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < PATH_BUCKETS; i++) {
+            seen += path_lengths[i];
+            if (seen >= target) return i;
+        }
+        return PATH_BUCKETS - 1;
+    }
+};
+
+#if SPLAY_TREE_STATS
+using DefaultSplayStats = CountingStats;
+#else
+using DefaultSplayStats = NoStats;
+#endif
@@ -1,75 +1,77 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <memory>
-#include <set>
 #include <vector>
-
-template<typename T, typename Comp = std::less<T>>
+#include "bulk_build.h"
+#include "key_prefix.h"
+#include "node_pool.h"
+#include "set_algebra.h"
+#include "splay_policy.h"
+#include "splay_stats.h"
+
+// SplayPolicy 决定访问后是否伸展及伸展方式，见 splay_policy.h
+// Stats 决定是否统计旋转、比较、伸展路径长度等，默认由 SPLAY_TREE_STATS 选择，见 splay_stats.h
+// 键为 std::string / std::string_view 且使用默认比较时，节点缓存 8 字节前缀以加速查找，见 key_prefix.h
+template<typename T, typename Comp = std::less<T>, typename SplayPolicy = FullSplay,
+         typename Stats = DefaultSplayStats>
 class SplayTree {
+    using order = key_prefix::order<T, Comp>;
+
 public:
-    struct node {
+    struct node : order::node_base {
         node *left = nullptr;
         node *right = nullptr;
         node *parent = nullptr;// 为了方便找到父节点，因为旋转后父节点向下指的指针会变
         T key;
-        size_t ref_count = 0;
+        size_t size = 1;// 以该节点为根的子树大小，旋转时维护
         
-        explicit node(const T& k) : key(k) {}
+        explicit node(const T& k) : order::node_base(k), key(k) {}
     };
 
+    static size_t subtree_size(const node* x) { return x ? x->size : 0; }
+
 private:
-    // 静态成员声明
-    static const size_t MAX_NODES = 100;
-    static std::set<node*> node_pool;
-    static size_t total_allocations;
-
-    // 节点内存管理
-    static node* allocate_node(const T& key) {
-        if (node_pool.size() >= MAX_NODES) {
-            cleanup_unused();
-        }
-        if (node_pool.size() >= MAX_NODES) return nullptr;
-        
-        auto* new_node = new node(key);
-        node_pool.insert(new_node);
-        total_allocations++;
-        return new_node;
+    // 默认情况下同一实例化类型的所有树共享一个节点内存池，容量随需增长
+    static NodePool<node> node_pool;
+
+    // 节点内存管理 - O(1)
+    node* allocate_node(const T& key) {
+        stats.allocation();
+        return pool->allocate(key);
     }
     
-    static void deallocate_node(node* n) {
-        if (!n) return;
-        auto it = node_pool.find(n);
-        if (it != node_pool.end()) {
-            node_pool.erase(it);
-            delete n;
-        }
+    void deallocate_node(node* n) {
+        pool->deallocate(n);
     }
 
 public:
+    // 归还完全空闲的内存块，存活节点不受影响
     static void cleanup_unused() {
-        std::vector<node*> to_remove;
-        for (auto* n : node_pool) {
-            if (n->ref_count == 0) {
-                to_remove.push_back(n);
-            }
-        }
-        for (auto* n : to_remove) {
-            deallocate_node(n);
-        }
+        node_pool.release_unused();
     }
 
 public:
     // 基本属性
     Comp comp;
+    SplayPolicy policy;
+    Stats stats;// 不随复制、移动转移，每棵树从零开始统计
     unsigned long p_size;// 节点数量
     node* root;
+    // 节点所在的内存池。拆分得到的树沿用原树的内存池；
+    // 连接、合并和集合运算要求参与的树使用同一个内存池
+    NodePool<node>* pool;
 
     // 构造和析构函数
-    SplayTree() : p_size(0), root(nullptr) {}
+    SplayTree() : p_size(0), root(nullptr), pool(&node_pool) {}
+
+    // 使用独立的内存池，pool 的生命周期必须长于这棵树；多线程下每个线程各用一个内存池即可互不干扰
+    explicit SplayTree(NodePool<node>& own_pool) : p_size(0), root(nullptr), pool(&own_pool) {}
     
-    // 复制构造
-    SplayTree(const SplayTree& other) : p_size(0), root(nullptr) {
+    // 复制构造：副本与原树使用同一个内存池
+    SplayTree(const SplayTree& other) : comp(other.comp), policy(other.policy), p_size(0), root(nullptr), pool(other.pool) {
         if (other.root) {
             root = copy_tree(other.root);
             p_size = other.p_size;
@@ -78,17 +80,19 @@ public:
     
     // 移动构造
     SplayTree(SplayTree&& other) noexcept 
-        : root(other.root), p_size(other.p_size) {
+        : comp(other.comp), policy(other.policy), p_size(other.p_size), root(other.root), pool(other.pool) {
         other.root = nullptr;
         other.p_size = 0;
     }
     
-    // 复制赋值
+    // 复制赋值：比较器和伸展策略随节点一起复制，节点仍分配在本树的内存池中
     SplayTree& operator=(const SplayTree& other) {
         if (this != &other) {
             clear(root);
             root = nullptr;
             p_size = 0;
+            comp = other.comp;
+            policy = other.policy;
             
             if (other.root) {
                 root = copy_tree(other.root);
@@ -102,8 +106,11 @@ public:
     SplayTree& operator=(SplayTree&& other) noexcept {
         if (this != &other) {
             clear(root);
+            comp = std::move(other.comp);
+            policy = std::move(other.policy);
             root = other.root;
             p_size = other.p_size;
+            pool = other.pool;
             other.root = nullptr;
             other.p_size = 0;
         }
@@ -122,70 +129,68 @@ public:
      * 插入操作 - 时间复杂度: 平摊 O(log n)，树高
      * 最坏情况: O(n)，当树完全不平衡时
      * 平摊分析: 通过伸展操作，频繁访问的节点会被移动到靠近根部的位置，从而优化后续访问
+     * 返回 key 所在的节点（新插入的或已存在的）
      */
-    void insert(const T &key) {
+    node* insert(const T &key) {
+        stats.access();
         if (!root) {// 树为空
             root = allocate_node(key);
-            if (!root) return;  // 内存池已满
             p_size++;
-            return;
+            return root;
         }
 
         node *z = root;
         node *p = nullptr;
+        size_t depth = 0;
+        typename order::probe probe(key);
+        int c = 0;
         
         while (z) {
             p = z;// p是父节点
-            if (comp(key, z->key))// key < z->key
+            c = probe.compare(comp, z);// 每层一次三路比较
+            stats.comparison();
+            if (c < 0)// key < z->key
                 z = z->left;
-            else if (comp(z->key, key))// key > z->key
+            else if (c > 0)// key > z->key
                 z = z->right;
             else {
-                splay(z);  // 如果找到相同的键，将其旋转到根
-                return;
+                access(z, depth);  // 如果找到相同的键，按策略将其旋转到根
+                return z;
             }
+            depth++;
         }
         
         z = allocate_node(key);// 分配一个内存，并创建一个对象
-        if (!z) return;  // 内存池已满
         z->parent = p;
         
-        if (comp(key, p->key))
+        if (c < 0)
             p->left = z;
         else
             p->right = z;
+
+        // 查找路径上每个祖先的子树都多了一个节点
+        for (node* a = p; a; a = a->parent) a->size++;
         
-        splay(z);// 把插入后的节点旋上去
         p_size++;
+        access(z, depth);// 按策略把插入后的节点旋上去
+        return z;
     }
 
     /**
      * 查找操作 - 时间复杂度: 平摊 O(log n) 树高
      * 最坏情况: O(n)，当树完全不平衡时
-     * 查找后会进行伸展操作，将查找的节点或最后访问的节点移到根部
+     * 查找后按伸展策略进行伸展，默认将查找的节点或最后访问的节点移到根部
      * 这种自调整特性使得频繁访问的元素查找效率更高
      */
     node* find(const T &key) {
+        stats.access();
         if (!root) return nullptr;
         
-        node* last_accessed = root;
-        node* current = root;
-        
-        while (current) {
-            last_accessed = current;
-            if (comp(current->key, key)) { // current -> key < key
-                current = current->right;
-            } else if (comp(key, current->key)) {// current -> key > key
-                current = current->left;
-            } else {
-                splay(current);
-                return current;
-            }
-        }
-        
-        // 将最后访问的节点伸展到根
-        splay(last_accessed);
-        return nullptr;
+        node* last_accessed;
+        size_t depth;
+        node* found = locate(key, last_accessed, depth);
+        access(last_accessed, depth);
+        return found;
     }
 
     /**
@@ -197,8 +202,8 @@ public:
      */
     void erase(const T &key) {
         // 1. 查找目标节点并伸展到根
-        node* target = find(key);
-        if (!target) return;  // 节点不存在，find已经将最后访问节点伸展到根
+        node* target = find_and_splay(key);
+        if (!target) return;  // 节点不存在，最后访问节点已伸展到根
         
         // 2. 分裂为左右子树
         node* left_tree = target->left;
@@ -223,6 +228,7 @@ public:
             // 现在max_node是左子树的根，且没有右子树
             max_node->right = right_tree;
             if (right_tree) right_tree->parent = max_node;
+            max_node->size += subtree_size(right_tree);
             
             root = max_node;
         }
@@ -237,6 +243,7 @@ public:
      * 执行常数时间的指针修改
      */
     void left_rotate(node *x) { //把这个节点左旋下去
+        stats.rotation();
         node *y = x->right;
         x->right = y->left;
 
@@ -250,12 +257,16 @@ public:
 
         y->left = x;
         x->parent = y;
+
+        y->size = x->size;
+        x->size = 1 + subtree_size(x->left) + subtree_size(x->right);
     }
     /**
      * 右旋转操作 - 时间复杂度: O(1)
      * 执行常数时间的指针修改
      */
     void right_rotate(node *x) { // 把这个节点右旋下去
+        stats.rotation();
         node *y = x->left;
         x->left = y->right;
 
@@ -269,6 +280,9 @@ public:
 
         y->right = x;
         x->parent = y; 
+
+        y->size = x->size;
+        x->size = 1 + subtree_size(x->left) + subtree_size(x->right);
     }
 
     /**
@@ -278,37 +292,155 @@ public:
      */
     void splay(node *x) {
         if (!x) return;
+        size_t length = 0;
         
         while (x->parent) {
             node *p = x->parent;
             node *g = p->parent;
+            length += g ? 2 : 1;
             
             if (!g) {  // Zig
+                stats.zig();
                 if (p->left == x)
                     right_rotate(p);
                 else   // zag
                     left_rotate(p);
             }
             else if (g->left == p && p->left == x) {  // Zig-Zig，左子树的左子树
+                stats.zig_zig();
                 right_rotate(g);
                 right_rotate(p);
             }
             else if (g->right == p && p->right == x) {  // Zig-Zig，右子树的右子树
+                stats.zig_zig();
                 left_rotate(g);
                 left_rotate(p);
             }
             else if (g->left == p && p->right == x) {  // Zig-Zag， 左子树的右子树
+                stats.zig_zag();
                 left_rotate(p);
                 right_rotate(g);
             }
             else {  // Zig-Zag，右子树的左子树
+                stats.zig_zag();
                 right_rotate(p);
                 left_rotate(g);
             }
         }
+        stats.splay_path(length);
         root = x;  // 每次旋转后，x都会变成根节点
     }
 
+    /**
+     * 半伸展操作 - 时间复杂度: 平摊 O(log n)
+     * Zig-Zig 情况只旋转祖父节点，然后从父节点继续向上；Zig-Zag 与完全伸展相同
+     * 被访问节点大约上移到原路径的一半，旋转次数约为完全伸展的一半
+     */
+    void semi_splay(node *x) {
+        if (!x) return;
+        size_t length = 0;
+
+        while (x->parent && x->parent->parent) {
+            node *p = x->parent;
+            node *g = p->parent;
+            length += 2;
+
+            if (g->left == p && p->left == x) {  // Zig-Zig：只旋转一次
+                stats.zig_zig();
+                right_rotate(g);
+                x = p;
+            }
+            else if (g->right == p && p->right == x) {
+                stats.zig_zig();
+                left_rotate(g);
+                x = p;
+            }
+            else if (g->left == p) {  // Zig-Zag
+                stats.zig_zag();
+                left_rotate(p);
+                right_rotate(g);
+            }
+            else {
+                stats.zig_zag();
+                right_rotate(p);
+                left_rotate(g);
+            }
+        }
+        if (x->parent) {  // 最后一步 Zig
+            stats.zig();
+            length++;
+            if (x->parent->left == x) right_rotate(x->parent);
+            else left_rotate(x->parent);
+        }
+        stats.splay_path(length);
+        root = x;
+    }
+
+private:
+    // 访问深度为 depth 的节点 x 之后，由伸展策略决定是否伸展，编译期选定伸展方式
+    void access(node *x, size_t depth) {
+        if (!policy.should_splay(depth)) return;
+        if constexpr (SplayPolicy::semi) semi_splay(x);
+        else splay(x);
+    }
+
+    /**
+     * 沿查找路径下降，不做任何伸展
+     * 返回 key 所在节点（不存在时为 nullptr），last 为最后访问的节点，depth 为其深度
+     */
+    node* locate(const T &key, node*& last, size_t& depth) {
+        node* current = root;
+        last = root;
+        depth = 0;
+        typename order::probe probe(key);
+        while (current) {
+            last = current;
+            int c = probe.compare(comp, current);
+            stats.comparison();
+            if (c > 0) { // current -> key < key
+                current = current->right;
+            } else if (c < 0) {// current -> key > key
+                current = current->left;
+            } else {
+                return current;
+            }
+            if (current) depth++;
+        }
+        return nullptr;
+    }
+
+    // 删除和拆分要求目标位于根部，不受伸展策略影响
+    node* find_and_splay(const T &key) {
+        if (!root) return nullptr;
+        node* last_accessed;
+        size_t depth;
+        node* found = locate(key, last_accessed, depth);
+        splay(last_accessed);
+        return found;
+    }
+
+    // 下降查找第一个不小于（strict 时为大于）key 的节点，最后访问的节点按策略伸展
+    node* bound(const T& key, bool strict) {
+        node* x = root;
+        node* result = nullptr;
+        node* last = root;
+        size_t depth = 0;
+        while (x) {
+            last = x;
+            stats.comparison();
+            if (strict ? comp(key, x->key) : !comp(x->key, key)) {
+                result = x;
+                x = x->left;
+            } else {
+                x = x->right;
+            }
+            if (x) depth++;
+        }
+        if (last) access(last, depth);
+        return result;
+    }
+
+public:
     // 辅助函数
     void replace(node *u, node *v) { 
         if( !u->parent ) root = v;
@@ -316,232 +448,422 @@ public:
         else u->parent->right = v;
         if( v ) v->parent = u->parent;
     }
-    node* subtree_minimum(node *u) { 
+    static node* subtree_minimum(node *u) { 
         while( u->left ) u = u->left;
         return u;
     }
-    node* subtree_maximum(node *u) {
+    static node* subtree_maximum(node *u) {
         while( u->right ) u = u->right;
         return u;
     }
+
+    // 中序后继/前驱：有右（左）子树时取其最小（最大）值，否则沿 parent 向上找第一个从左（右）边上来的祖先
+    static node* successor(node *x) {
+        if (x->right) return subtree_minimum(x->right);
+        node* p = x->parent;
+        while (p && x == p->right) {
+            x = p;
+            p = p->parent;
+        }
+        return p;
+    }
+    static node* predecessor(node *x) {
+        if (x->left) return subtree_maximum(x->left);
+        node* p = x->parent;
+        while (p && x == p->left) {
+            x = p;
+            p = p->parent;
+        }
+        return p;
+    }
     
-    // 新增内存清理
+    // 释放以 x 为根的子树：把左孩子不断右旋上来，树被压成右链后逐个释放，额外空间 O(1)
+    // 即使树退化成一条链也不会递归过深；节点马上被释放，旋转时不维护 parent 和 size
     void clear(node *x) {
-        if (x) {
-            clear(x->left);
-            clear(x->right);
-            deallocate_node(x);
+        while (x) {
+            if (x->left) {
+                node* l = x->left;
+                x->left = l->right;
+                l->right = x;
+                x = l;
+            } else {
+                node* next = x->right;
+                deallocate_node(x);
+                x = next;
+            }
         }
     }
 
 public:
-    // 拆分
     /**
-     * 树的拆分操作 - 时间复杂度: O(log n)
-     * 1. 查找并伸展操作 - O(log n)
-     * 2. 分割为两棵树 - O(1)
-     * 
-     * 将树拆分为两棵子树，使得左子树中所有键值小于等于key，
-     * 右子树中所有键值大于key
+     * 由有序序列批量构建 - 时间复杂度: O(n)
+     * [first, last) 必须按 comp 升序排列，相邻的重复键只保留第一个；树中原有节点会被释放
+     * 所有节点一次性从内存池取得一段连续槽位，构建出完全平衡的树
+     * threads > 1 时并行构造节点并分治链接，threads 为 0 表示使用全部硬件线程
      */
-    std::pair<SplayTree*, SplayTree*> split(const T& key) {
-        if (!root) return {new SplayTree(), new SplayTree()};
-
-        // 1. 先将最接近key的节点旋转到根
-        find(key);  
-
-        // 创建两棵新树
-        SplayTree* left = new SplayTree();
-        SplayTree* right = new SplayTree();
-
-        // 确保拆分值在左子树
-        if (!comp(key, root->key)) {  // 如果 key >= root->key
-            // 根节点及其左子树归入左子树
-            left->root = root;
-            if (root->right) {
-                right->root = root->right;
-                root->right->parent = nullptr;
-                root->right = nullptr;
-            }
-        } else {  // 如果 key < root->key
-            // 右子树和根节点归入右子树
-            right->root = root;
-            if (root->left) {
-                left->root = root->left;
-                root->left->parent = nullptr;
-                root->left = nullptr;
-            }
-        }
-
-        // 更新两棵子树的大小
-        if (left->root) left->p_size = countNodes(left->root);
-        if (right->root) right->p_size = countNodes(right->root);
-
-        // 清空原树
+    template<typename RandomIt>
+    void build_from_sorted(RandomIt first, RandomIt last, unsigned threads = 1) {
+        clear(root);
         root = nullptr;
         p_size = 0;
 
-        return {left, right};
+        size_t total = static_cast<size_t>(last - first);
+        std::vector<size_t> unique_pos;// 只有出现重复键时才记录不重复键的下标
+        for (size_t i = 1; i < total; i++) {
+            if (!comp(first[i - 1], first[i])) {
+                unique_pos.reserve(total);
+                unique_pos.push_back(0);
+                for (size_t j = 1; j < total; j++) {
+                    if (comp(first[unique_pos.back()], first[j])) unique_pos.push_back(j);
+                }
+                break;
+            }
+        }
+        size_t n = unique_pos.empty() ? total : unique_pos.size();
+
+        root = bulk_build::build(*pool, n, [&](void* storage, size_t i) {
+            ::new (storage) node(first[unique_pos.empty() ? i : unique_pos[i]]);
+        }, threads);
+        stats.allocation(n);
+        p_size = n;
     }
 
     /**
-     * 树的合并操作 - 时间复杂度: O(log n)
-     * 1. 查找最大/最小节点 - O(log n)
-     * 2. 伸展操作 - O(log n)
-     * 3. 树的连接 - O(1)
-     * 
-     * 合并两棵树的前提是t1中的所有键值必须小于t2中的所有键值
+     * 按排名取节点 - 时间复杂度: 平摊 O(log n)
+     * 返回中序第 k 个节点（从 0 开始），并将其伸展到根；k 越界时返回 nullptr
      */
-    static SplayTree* merge(SplayTree* t1, SplayTree* t2) {
-        // 空树快速处理
-        if (!t1 || !t1->root) {
-            auto* result = new SplayTree();
-            if (t2 && t2->root) {
-                result->root = t2->root;
-                result->p_size = t2->p_size;
-                t2->root = nullptr;
-                t2->p_size = 0;
+    node* kth(size_t k) {
+        if (k >= subtree_size(root)) return nullptr;
+        node* x = root;
+        for (;;) {
+            size_t left_size = subtree_size(x->left);
+            if (k < left_size) {
+                x = x->left;
+            } else if (k > left_size) {
+                k -= left_size + 1;
+                x = x->right;
+            } else {
+                break;
             }
-            delete t1;
-            delete t2;
-            return result;
         }
-        if (!t2 || !t2->root) {
-            auto* result = new SplayTree();
-            result->root = t1->root;
-            result->p_size = t1->p_size;
-            t1->root = nullptr;
-            t1->p_size = 0;
-            delete t1;
-            delete t2;
-            return result;
+        splay(x);
+        return x;
+    }
+
+    /**
+     * 求排名 - 时间复杂度: 平摊 O(log n)
+     * 返回树中严格小于 key 的键的个数，最后访问的节点被伸展到根
+     */
+    size_t rank(const T& key) {
+        size_t r = 0;
+        node* x = root;
+        node* last = root;
+        while (x) {
+            last = x;
+            if (comp(x->key, key)) {
+                r += subtree_size(x->left) + 1;
+                x = x->right;
+            } else {
+                x = x->left;
+            }
         }
+        if (last) splay(last);
+        return r;
+    }
+
+    // 中位数节点（偶数个节点时取靠右的一个），空树返回 nullptr
+    node* median() { return kth(subtree_size(root) / 2); }
 
-        // 验证合并条件
-        node* max_node = t1->subtree_maximum(t1->root);
-        node* min_node = t2->subtree_minimum(t2->root);
-        if (!(t1->comp(max_node->key, min_node->key))) {// 左边最大的比右边的最小的大
-            delete t1;
-            delete t2;
-            return nullptr;
+    /**
+     * 双向只读迭代器，按中序（键值升序）遍历
+     * 借助 parent 指针求后继/前驱，完整遍历一次共 O(n)，单步平摊 O(1)
+     * 伸展只改变树的形状、不移动节点，因此查找和旋转不会使迭代器失效；
+     * 只有指向被删除节点的迭代器失效。键值决定节点位置，不允许通过迭代器修改
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return x->key; }
+        pointer operator->() const { return &x->key; }
+
+        const_iterator& operator++() {
+            x = successor(x);
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        // end() 自减得到最大值
+        const_iterator& operator--() {
+            x = x ? predecessor(x) : subtree_maximum(tree->root);
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator old = *this;
+            --*this;
+            return old;
         }
 
-        // 合并过程
-        auto* result = new SplayTree();
-        t1->splay(max_node);  // 将最大节点旋转到根
-        
-        // 直接连接两棵树
-        t1->root->right = t2->root;
-        if (t2->root) {
-            t2->root->parent = t1->root;
+        bool operator==(const const_iterator& other) const { return x == other.x; }
+        bool operator!=(const const_iterator& other) const { return x != other.x; }
+
+    private:
+        friend class SplayTree;
+        const_iterator(node* n, const SplayTree* t) : x(n), tree(t) {}
+
+        node* x = nullptr;// nullptr 表示 end()
+        const SplayTree* tree = nullptr;
+    };
+    using iterator = const_iterator;
+
+    // 遍历不伸展，不改变树的形状 - begin 为 O(树高)，end 为 O(1)
+    const_iterator begin() const { return {root ? subtree_minimum(root) : nullptr, this}; }
+    const_iterator end() const { return {nullptr, this}; }
+
+    /**
+     * 第一个不小于 key 的位置 - 时间复杂度: 平摊 O(log n)
+     * 查找路径上最后访问的节点按伸展策略伸展，重复的范围查询因此保持对数代价
+     */
+    const_iterator lower_bound(const T& key) { return {bound(key, false), this}; }
+
+    // 第一个大于 key 的位置 - 时间复杂度: 平摊 O(log n)
+    const_iterator upper_bound(const T& key) { return {bound(key, true), this}; }
+
+    // 等于 key 的区间，key 不存在时为空区间 - 时间复杂度: 平摊 O(log n)
+    std::pair<const_iterator, const_iterator> equal_range(const T& key) {
+        const_iterator first = lower_bound(key);
+        if (first == end() || comp(key, *first)) return {first, first};
+        return {first, std::next(first)};
+    }
+
+    /**
+     * 删除区间 [first, last) - 时间复杂度: 平摊 O(log n) + 释放 k 个节点的 O(k)
+     * 不逐个删除：first 伸展到根后断开左子树，last 伸展到根后它的左子树恰好是待删区间，
+     * 整块摘下释放，再把原来的左子树接回 last 的左边。返回 last
+     */
+    const_iterator erase(const_iterator first, const_iterator last) {
+        if (first == last) return last;
+        node* a = first.x;
+        node* b = last.x;
+
+        // 1. 小于 first 的部分
+        splay(a);
+        node* smaller = a->left;
+        a->left = nullptr;
+        a->size -= subtree_size(smaller);
+        if (smaller) smaller->parent = nullptr;
+
+        // 2. 待删区间：last 之前的全部节点，last 为 end() 时就是剩下的整棵树
+        node* doomed;
+        if (b) {
+            splay(b);
+            doomed = b->left;
+            b->left = nullptr;
+            b->size -= doomed->size;
+            doomed->parent = nullptr;
+        } else {
+            doomed = root;
+            root = nullptr;
         }
-        
-        result->root = t1->root;
-        result->p_size = t1->p_size + t2->p_size;
+        p_size -= subtree_size(doomed);
+        clear(doomed);
+
+        // 3. 接回：last 此时没有左孩子
+        if (!root) {
+            root = smaller;
+        } else if (smaller) {
+            root->left = smaller;
+            smaller->parent = root;
+            root->size += smaller->size;
+        }
+        return last;
+    }
 
-        // 重置原树
-        t1->root = t2->root = nullptr;
-        t1->p_size = t2->p_size = 0;
-        
-        // 批量更新引用计数
-        if (result->root) {
-            result->batch_update_ref_counts(result->root);
+    /**
+     * 按值拆分 - 时间复杂度: 平摊 O(log n)
+     * 1. 查找并伸展操作 - O(log n)
+     * 2. 断开根的一侧 - O(1)，两棵树的大小直接取根节点记录的子树大小
+     *
+     * 左树包含所有小于等于 key 的键值，右树包含所有大于 key 的键值，本树被清空。
+     * 两棵树通过移动返回，不分配树对象，也不遍历节点
+     */
+    std::pair<SplayTree, SplayTree> split_at(const T& key) {
+        std::pair<SplayTree, SplayTree> result;
+        result.first.comp = result.second.comp = comp;
+        result.first.policy = result.second.policy = policy;
+        result.first.pool = result.second.pool = pool;
+        if (!root) return result;
+
+        // 先将最接近key的节点旋转到根
+        find_and_splay(key);
+
+        if (!comp(key, root->key)) {// key >= root->key：根节点及其左子树归入左树
+            result.first.root = root;
+            result.second.root = root->right;
+            root->right = nullptr;
+        } else {// key < root->key：根节点及其右子树归入右树
+            result.second.root = root;
+            result.first.root = root->left;
+            root->left = nullptr;
         }
+        if (result.first.root) result.first.root->parent = nullptr;
+        if (result.second.root) result.second.root->parent = nullptr;
+        root->size = 1 + subtree_size(root->left) + subtree_size(root->right);
 
-        delete t1;
-        delete t2;
+        result.first.p_size = subtree_size(result.first.root);
+        result.second.p_size = subtree_size(result.second.root);
+        root = nullptr;
+        p_size = 0;
         return result;
     }
 
-private:
-    // 更新引用计数
-    void update_ref_counts(node* n) {
-        if (!n) return;
-        n->ref_count++;
-        update_ref_counts(n->left);
-        update_ref_counts(n->right);
+    /**
+     * 按值合并 - 时间复杂度: 平摊 O(log n)
+     * 把 left 的最大节点伸展到根，它没有右孩子，直接挂上 right - O(1)
+     *
+     * 前提是 left 中所有键值都小于 right 中所有键值，这里不做检查（需要检查时使用 merge）。
+     * 两棵输入树被清空
+     */
+    static SplayTree join(SplayTree&& left, SplayTree&& right) {
+        SplayTree result(std::move(left));
+        if (!right.root) return result;
+        if (!result.root) {
+            result.root = right.root;
+            result.p_size = right.p_size;
+            result.pool = right.pool;
+        } else {
+            node* max_node = result.subtree_maximum(result.root);
+            result.splay(max_node);
+            max_node->right = right.root;
+            right.root->parent = max_node;
+            max_node->size += right.root->size;
+            result.p_size += right.p_size;
+        }
+        right.root = nullptr;
+        right.p_size = 0;
+        return result;
     }
 
-    // 减少引用计数
-    void decrease_ref_counts(node* n) {
-        if (!n) return;
-        n->ref_count--;
-        decrease_ref_counts(n->left);
-        decrease_ref_counts(n->right);
+    /**
+     * 以 pivot 为根连接两棵树 - 时间复杂度: O(1)
+     * 只分配 pivot 一个节点，left 和 right 原样成为它的左右子树，不伸展
+     *
+     * 前提是 left 中的键值 < pivot < right 中的键值，这里不做检查。两棵输入树被清空
+     */
+    static SplayTree join3(SplayTree&& left, const T& pivot, SplayTree&& right) {
+        node* x = left.pool->allocate(pivot);
+        SplayTree result = join3(std::move(left), x, std::move(right));
+        result.stats.allocation();
+        return result;
     }
 
-    // 批量更新引用计数
-    void batch_update_ref_counts(node* n) {
-        if (!n) return;
-        
-        std::vector<node*> nodes;
-        collect_nodes(n, nodes);
-        
-        for (node* node : nodes) {
-            node->ref_count++;
-        }
+    /**
+     * 以已有的游离节点 x 为根连接两棵树 - 时间复杂度: O(1)
+     * 不分配内存，x 必须来自同一个内存池；集合运算的并行递归靠它复用枢轴节点。
+     * 结果沿用 left 的内存池、比较器和伸展策略
+     */
+    static SplayTree join3(SplayTree&& left, node* x, SplayTree&& right) {
+        x->left = left.root;
+        x->right = right.root;
+        x->parent = nullptr;
+        if (x->left) x->left->parent = x;
+        if (x->right) x->right->parent = x;
+        x->size = 1 + subtree_size(x->left) + subtree_size(x->right);
+
+        SplayTree result(*left.pool);
+        result.comp = left.comp;
+        result.policy = left.policy;
+        result.root = x;
+        result.p_size = x->size;
+        left.root = right.root = nullptr;
+        left.p_size = right.p_size = 0;
+        return result;
     }
 
-    void collect_nodes(node* n, std::vector<node*>& nodes) {
-        if (!n) return;
-        nodes.push_back(n);
-        collect_nodes(n->left, nodes);
-        collect_nodes(n->right, nodes);
+    /**
+     * 树的拆分操作 - 时间复杂度: O(log n)
+     * 与 split_at 相同，只是把结果放到新分配的两棵树中返回，调用者负责 delete
+     */
+    std::pair<SplayTree*, SplayTree*> split(const T& key) {
+        auto [left, right] = split_at(key);
+        return {new SplayTree(std::move(left)), new SplayTree(std::move(right))};
     }
 
-    // 添加树复制辅助函数
-    node* copy_tree(node* src) {
-        if (!src) return nullptr;
-        
-        node* new_node = allocate_node(src->key);
-        if (!new_node) return nullptr;
-        
-        new_node->ref_count = src->ref_count;
-        
-        if (src->left) {
-            new_node->left = copy_tree(src->left);
-            if (new_node->left) {
-                new_node->left->parent = new_node;
-            }
-        }
-        
-        if (src->right) {
-            new_node->right = copy_tree(src->right);
-            if (new_node->right) {
-                new_node->right->parent = new_node;
-            }
+    /**
+     * 树的合并操作 - 时间复杂度: O(log n)
+     * 接管并 delete t1、t2，返回新分配的合并结果；
+     * t1 中的所有键值必须小于 t2 中的所有键值，否则返回 nullptr
+     */
+    static SplayTree* merge(SplayTree* t1, SplayTree* t2) {
+        SplayTree empty;
+        SplayTree& left = t1 ? *t1 : empty;
+        SplayTree& right = t2 ? *t2 : empty;
+
+        // 验证合并条件：左边最大的必须比右边最小的小
+        SplayTree* result = nullptr;
+        if (!left.root || !right.root ||
+            left.comp(left.subtree_maximum(left.root)->key, right.subtree_minimum(right.root)->key)) {
+            result = new SplayTree(join(std::move(left), std::move(right)));
         }
-        
-        return new_node;
+        delete t1;
+        delete t2;
+        return result;
     }
 
-    // 辅助函数
-    unsigned long countNodes(node* x) const {
-        if (!x) return 0;
-        return 1 + countNodes(x->left) + countNodes(x->right);
+    /**
+     * 集合运算：并集、交集、差集(a - b) - 时间复杂度: O(m log(n/m + 1))，m、n 为较小和较大的树的节点数
+     * 两棵树的键值区间可以任意重叠；两棵输入树被消耗，节点尽量复用，不再需要的节点被释放
+     * threads > 1 时并行递归，threads 为 0 表示使用全部硬件线程，见 set_algebra.h
+     */
+    static SplayTree set_union(SplayTree&& a, SplayTree&& b, unsigned threads = 1) {
+        return set_algebra::apply(set_algebra::op::unite, std::move(a), std::move(b), threads);
+    }
+    static SplayTree set_intersection(SplayTree&& a, SplayTree&& b, unsigned threads = 1) {
+        return set_algebra::apply(set_algebra::op::intersect, std::move(a), std::move(b), threads);
+    }
+    static SplayTree set_difference(SplayTree&& a, SplayTree&& b, unsigned threads = 1) {
+        return set_algebra::apply(set_algebra::op::subtract, std::move(a), std::move(b), threads);
     }
 
-    void erase_impl(const T &key) {
-        node *z = find(key);
-        if (!z) return;
-
-        splay(z);
-
-        if (!z->left) replace(z, z->right);
-        else if (!z->right) replace(z, z->left);
-        else {
-            node *y = subtree_minimum(z->right);
-            if (y->parent != z) {
-                replace(y, y->right);
-                y->right = z->right;
-                y->right->parent = y;
+private:
+    // 复制以 src 为根的子树：借助 parent 指针在原树和新树上同步做先序遍历，额外空间 O(1)
+    // 新节点的孩子初始为空，据此判断某个方向是否已经复制过
+    node* copy_tree(node* src) {
+        if (!src) return nullptr;
+        node* result = allocate_node(src->key);
+        result->size = src->size;
+
+        node* from = src;
+        node* to = result;
+        for (;;) {
+            if (from->left && !to->left) {
+                to->left = allocate_node(from->left->key);
+                to->left->parent = to;
+                from = from->left;
+                to = to->left;
+            } else if (from->right && !to->right) {
+                to->right = allocate_node(from->right->key);
+                to->right->parent = to;
+                from = from->right;
+                to = to->right;
+            } else {
+                if (from == src) break;
+                from = from->parent;
+                to = to->parent;
+                continue;
             }
-            replace(z, y);
-            y->left = z->left;
-            y->left->parent = y;
+            to->size = from->size;
         }
-        deallocate_node(z); // 修复内存泄漏
-        p_size--;
+        return result;
     }
 
     const T& minimum( ) { return subtree_minimum( root )->key; }
@@ -551,30 +873,24 @@ private:
 public: unsigned long size( ) const { return p_size; }
 
 public:
-    // 垃圾回收
+    // 垃圾回收：归还空闲内存块，存活节点由各自的树在析构时释放
     static void cleanup() {
-        for (auto* n : node_pool) {
-            delete n;
-        }
-        node_pool.clear();
-    }
-
-    // 容量检查
-    bool is_full() const {
-        return node_pool.size() >= MAX_NODES;
+        node_pool.release_unused();
     }
 
     // 添加静态方法访问器
-    static size_t get_current_nodes() { return node_pool.size(); }
-    static size_t get_total_allocations() { return total_allocations; }
+    static size_t get_current_nodes() { return node_pool.current_nodes(); }
+    static size_t get_total_allocations() { return node_pool.allocations(); }
+    static size_t get_peak_nodes() { return node_pool.peak(); }
+    static size_t get_bytes_in_use() { return node_pool.bytes_in_use(); }
+    static size_t get_bytes_reserved() { return node_pool.bytes_reserved(); }
+    static size_t get_chunk_count() { return node_pool.chunk_count(); }
+
+    // 统计信息，Stats 为 NoStats 时是一个空对象
+    const Stats& get_stats() const { return stats; }
+    void reset_stats() { stats.reset(); }
 };
 
 // 静态成员定义
-template<typename T, typename Comp>
-std::set<typename SplayTree<T, Comp>::node*> SplayTree<T, Comp>::node_pool;
-
-template<typename T, typename Comp>
-size_t SplayTree<T, Comp>::total_allocations = 0;
-
-template<typename T, typename Comp>
-const size_t SplayTree<T, Comp>::MAX_NODES;
\ No newline at end of file
+template<typename T, typename Comp, typename SplayPolicy, typename Stats>
+NodePool<typename SplayTree<T, Comp, SplayPolicy, Stats>::node> SplayTree<T, Comp, SplayPolicy, Stats>::node_pool;
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * 字符串内存区（bump 分配器）
+ *
+ * 把字符串依次复制到连续的大块内存中，返回指向副本的 std::string_view：
+ * - 分配：在当前块的尾部顺序取出所需字节 - O(长度)，只有块用完时才向系统申请新块
+ * - 释放：不支持单个字符串的释放，clear 或析构时整块归还 - O(块数)
+ *
+ * 适合"只增不删"的键，例如词频统计中的单词：每个不同单词只复制一次，
+ * 节点里只保存 (指针, 长度)，不再为每个单词单独申请一块堆内存。
+ * 副本不以 '\0' 结尾，字符串之间紧密排列，不做对齐。
+ * 与 NodePool 一样不做线程同步。
+ */
+class StringArena {
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t capacity;
+    };
+
+public:
+    static constexpr size_t FIRST_BLOCK_BYTES = 4 * 1024;
+    static constexpr size_t MAX_BLOCK_BYTES = 1024 * 1024;
+
+    StringArena() = default;
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    /**
+     * 取得 n 个连续的未初始化字节 - 时间复杂度: 平摊 O(1)
+     * 超过块上限的请求单独占用一个恰好大小的块，当前块的剩余空间保留给后续的小请求
+     */
+    char* allocate(size_t n) {
+        if (n == 0) return nullptr;
+        if (static_cast<size_t>(bump_end - bump) < n) {
+            if (n > MAX_BLOCK_BYTES / 4) {
+                blocks.push_back({std::unique_ptr<char[]>(new char[n]), n});
+                reserved += n;
+                used += n;
+                return blocks.back().data.get();
+            }
+            grow(n);
+        }
+        char* p = bump;
+        bump += n;
+        used += n;
+        return p;
+    }
+
+    // 复制 s 并返回指向副本的视图 - 时间复杂度: O(|s|)
+    std::string_view intern(std::string_view s) {
+        char* p = allocate(s.size());
+        if (p) std::memcpy(p, s.data(), s.size());
+        return std::string_view(p, s.size());
+    }
+
+    // 一次性归还全部内存，之前返回的视图全部失效
+    void clear() {
+        blocks.clear();
+        bump = bump_end = nullptr;
+        next_block_bytes = FIRST_BLOCK_BYTES;
+        reserved = used = 0;
+    }
+
+    // 统计信息
+    size_t block_count() const { return blocks.size(); }
+    size_t bytes_in_use() const { return used; }
+    size_t bytes_reserved() const { return reserved; }
+
+private:
+    void grow(size_t at_least) {
+        size_t capacity = std::max(next_block_bytes, at_least);
+        blocks.push_back({std::unique_ptr<char[]>(new char[capacity]), capacity});
+        bump = blocks.back().data.get();
+        bump_end = bump + capacity;
+        reserved += capacity;
+        next_block_bytes = std::min(next_block_bytes * 2, MAX_BLOCK_BYTES);
+    }
+
+    std::vector<Block> blocks;
+    char* bump = nullptr;       // 当前块中第一个未使用的字节
+    char* bump_end = nullptr;
+    size_t next_block_bytes = FIRST_BLOCK_BYTES;
+    size_t reserved = 0;
+    size_t used = 0;
+};
@@ -0,0 +1,371 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include "splay_tree.h"
+#include "word_frequency.h"
+#include "zipf_generator.h"
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * 参数化的数据结构性能测试，输出机器可读的 CSV / JSON，用于跟踪性能回退和按数据选择结构
+ *
+ * 用法: structure_benchmark [选项]
+ *   --keys N        不同键的个数（默认 100000），测试前全部预先插入
+ *   --ops N         每轮计时的操作数（默认 1000000）
+ *   --type T        键类型: int | string（默认 string，随机的 3~12 个小写字母）
+ *   --dist D        访问分布: uniform | zipf:S | sequential | hotshift（默认 zipf:1.0）
+ *                   hotshift: 90% 的操作落在 1% 的热点键上，热点集合每 1/10 的操作换一次
+ *   --mix I:F:E     插入:查找:删除 的比例（默认 10:90:0）；插入已存在的键时只计数
+ *   --reps N        计时轮数（默认 5），每轮使用新建的结构
+ *   --warmup N      不计时的预热轮数（默认 1）
+ *   --cpu C         把进程绑定到第 C 个 CPU（仅 Linux，默认不绑定）
+ *   --format F      csv | json（默认 csv）
+ *   --only A,B      只测试列出的结构
+ *   --seed S        随机种子（默认 42）
+ *
+ * 参与对比的结构：
+ *   splay_full / splay_semi    通用 SplayTree<T>（splay_tree.h），完全伸展 / 半伸展
+ *   word_splay / word_topdown  词频统计的自底向上 / 自顶向下伸展树，每次完全伸展（仅 string，不支持删除）
+ *   bst                        词频统计的普通二叉搜索树（仅 string，不支持删除）
+ *   std_map / std_unordered_map
+ * 不适用的组合（例如 int 键的词频树、含删除操作的混合）直接跳过，跳过的原因写到标准错误。
+ * 每轮的结果只统计计时阶段；hits 为查找命中的次数，同一组参数下各结构应当相同，可用于核对正确性。
+ */
+
+struct Config {
+    size_t keys = 100000;
+    size_t ops = 1000000;
+    string type = "string";
+    string dist = "zipf:1.0";
+    string mix = "10:90:0";
+    int reps = 5;
+    int warmup = 1;
+    int cpu = -1;
+    string format = "csv";
+    vector<string> only;
+    uint32_t seed = 42;
+};
+
+enum class OpKind : uint8_t { insert, find, erase };
+
+struct Op {
+    OpKind kind;
+    uint32_t key;   // 键在键表中的下标
+};
+
+struct Result {
+    string structure;
+    double minNs, medianNs, meanNs, maxNs;  // 每次操作的纳秒数
+    size_t hits;
+};
+
+// 绑定到指定 CPU，减少迁移和频率差异带来的波动
+bool pinToCpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+vector<int> makeIntKeys(size_t n, mt19937& gen) {
+    unordered_set<int> seen;
+    vector<int> keys;
+    keys.reserve(n);
+    uniform_int_distribution<int> dist(0, numeric_limits<int>::max());
+    while (keys.size() < n) {
+        int k = dist(gen);
+        if (seen.insert(k).second) keys.push_back(k);
+    }
+    return keys;
+}
+
+vector<string> makeStringKeys(size_t n, mt19937& gen) {
+    unordered_set<string> seen;
+    vector<string> keys;
+    keys.reserve(n);
+    uniform_int_distribution<int> length(3, 12), letter(0, 25);
+    while (keys.size() < n) {
+        string k(length(gen), 'a');
+        for (auto& c : k) c = char('a' + letter(gen));
+        if (seen.insert(k).second) keys.push_back(std::move(k));
+    }
+    return keys;
+}
+
+/**
+ * 生成操作序列：先按访问分布选出键的排名，再映射到键表下标
+ * 键表本身是随机顺序，所以排名与键的大小无关；sequential 按键的升序依次访问
+ */
+template<typename T>
+vector<Op> makeOps(const Config& config, const vector<T>& keys, mt19937& gen) {
+    size_t n = keys.size();
+    vector<uint32_t> byRank(n);
+    for (size_t i = 0; i < n; i++) byRank[i] = uint32_t(i);
+    if (config.dist == "sequential") {
+        sort(byRank.begin(), byRank.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    }
+
+    function<size_t(size_t)> pick;
+    uniform_int_distribution<size_t> uniform(0, n - 1);
+    unique_ptr<ZipfGenerator> zipf;
+    size_t hotSize = max<size_t>(1, n / 100), hotStart = 0;
+    if (config.dist == "uniform") {
+        pick = [&](size_t) { return uniform(gen); };
+    } else if (config.dist == "sequential") {
+        pick = [&](size_t i) { return i % n; };
+    } else if (config.dist == "hotshift") {
+        size_t period = max<size_t>(1, config.ops / 10);
+        pick = [&, period](size_t i) {
+            if (i % period == 0) hotStart = uniform(gen);
+            if (gen() % 10 != 0) return (hotStart + gen() % hotSize) % n;
+            return uniform(gen);
+        };
+    } else if (config.dist.compare(0, 5, "zipf:") == 0) {
+        zipf.reset(new ZipfGenerator(n, stod(config.dist.substr(5))));
+        pick = [&](size_t) { return (*zipf)(gen); };
+    } else {
+        throw invalid_argument("未知的访问分布: " + config.dist);
+    }
+
+    unsigned weight[3] = {0, 0, 0};
+    if (sscanf(config.mix.c_str(), "%u:%u:%u", &weight[0], &weight[1], &weight[2]) != 3 ||
+        weight[0] + weight[1] + weight[2] == 0) {
+        throw invalid_argument("操作比例格式应为 插入:查找:删除，例如 10:90:0");
+    }
+    discrete_distribution<int> kind({double(weight[0]), double(weight[1]), double(weight[2])});
+
+    vector<Op> ops(config.ops);
+    for (size_t i = 0; i < ops.size(); i++) {
+        ops[i].kind = OpKind(kind(gen));
+        ops[i].key = byRank[pick(i)];
+    }
+    return ops;
+}
+
+// 各结构的统一接口：insert 对已存在的键只计数，find 返回是否存在
+template<typename T, typename Policy>
+struct GenericSplay {
+    static constexpr bool canErase = true;
+    SplayTree<T, std::less<T>, Policy> tree;
+    void insert(const T& k) { tree.insert(k); }
+    bool find(const T& k) { return tree.find(k) != nullptr; }
+    void erase(const T& k) { tree.erase(k); }
+};
+
+struct WordSplay {
+    static constexpr bool canErase = false;
+    word_frequency::SplayTree<FullSplay> tree;
+    void insert(const string& k) { tree.insert(k); }
+    bool find(const string& k) { return tree.getCount(k) > 0; }
+    void erase(const string&) {}
+};
+
+struct WordTopDown {
+    static constexpr bool canErase = false;
+    word_frequency::TopDownSplayTree tree;
+    void insert(const string& k) { tree.insert(k); }
+    bool find(const string& k) { return tree.getCount(k) > 0; }
+    void erase(const string&) {}
+};
+
+struct WordBST {
+    static constexpr bool canErase = false;
+    word_frequency::BST tree;
+    void insert(const string& k) { tree.insert(k); }
+    bool find(const string& k) { return tree.getCount(k) > 0; }
+    void erase(const string&) {}
+};
+
+template<typename T, typename Map>
+struct StdMap {
+    static constexpr bool canErase = true;
+    Map map;
+    void insert(const T& k) { ++map[k]; }
+    bool find(const T& k) { return map.find(k) != map.end(); }
+    void erase(const T& k) { map.erase(k); }
+};
+
+bool selected(const Config& config, const string& name) {
+    return config.only.empty() || find(config.only.begin(), config.only.end(), name) != config.only.end();
+}
+
+/**
+ * 测试一种结构：预热 warmup 轮，再计时 reps 轮；每轮新建结构、预先插入全部键（不计时），再执行操作序列
+ */
+template<typename Structure, typename T>
+void runStructure(const string& name, const Config& config, const vector<T>& keys,
+                  const vector<Op>& ops, vector<Result>& results) {
+    if (!selected(config, name)) return;
+    bool hasErase = any_of(ops.begin(), ops.end(), [](const Op& op) { return op.kind == OpKind::erase; });
+    if (hasErase && !Structure::canErase) {
+        cerr << "跳过 " << name << ": 不支持删除" << endl;
+        return;
+    }
+
+    vector<double> nsPerOp;
+    size_t hits = 0;
+    for (int round = 0; round < config.warmup + config.reps; round++) {
+        Structure s;
+        for (const T& k : keys) s.insert(k);
+
+        size_t found = 0;
+        auto start = high_resolution_clock::now();
+        for (const Op& op : ops) {
+            const T& k = keys[op.key];
+            switch (op.kind) {
+                case OpKind::insert: s.insert(k); break;
+                case OpKind::find: found += s.find(k); break;
+                case OpKind::erase: s.erase(k); break;
+            }
+        }
+        auto end = high_resolution_clock::now();
+        if (round < config.warmup) continue;
+        nsPerOp.push_back(double(duration_cast<nanoseconds>(end - start).count()) / max<size_t>(1, ops.size()));
+        hits = found;
+    }
+
+    sort(nsPerOp.begin(), nsPerOp.end());
+    double mean = 0;
+    for (double x : nsPerOp) mean += x;
+    mean /= nsPerOp.size();
+    size_t mid = nsPerOp.size() / 2;
+    double median = nsPerOp.size() % 2 ? nsPerOp[mid] : (nsPerOp[mid - 1] + nsPerOp[mid]) / 2;
+    results.push_back({name, nsPerOp.front(), median, mean, nsPerOp.back(), hits});
+}
+
+template<typename T>
+vector<Result> runAll(const Config& config, const vector<T>& keys, const vector<Op>& ops) {
+    vector<Result> results;
+    runStructure<GenericSplay<T, FullSplay>>("splay_full", config, keys, ops, results);
+    runStructure<GenericSplay<T, SemiSplay>>("splay_semi", config, keys, ops, results);
+    if constexpr (is_same<T, string>::value) {
+        runStructure<WordSplay>("word_splay", config, keys, ops, results);
+        runStructure<WordTopDown>("word_topdown", config, keys, ops, results);
+        runStructure<WordBST>("bst", config, keys, ops, results);
+    } else {
+        for (const char* name : {"word_splay", "word_topdown", "bst"}) {
+            if (selected(config, name)) cerr << "跳过 " << name << ": 只支持 string 键" << endl;
+        }
+    }
+    runStructure<StdMap<T, map<T, int>>>("std_map", config, keys, ops, results);
+    runStructure<StdMap<T, unordered_map<T, int>>>("std_unordered_map", config, keys, ops, results);
+    return results;
+}
+
+// JSON 字符串转义：这里只会出现参数和结构名，转义引号和反斜杠即可
+string jsonQuote(const string& s) {
+    string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+void writeCsv(ostream& out, const Config& config, const vector<Result>& results) {
+    out << "structure,key_type,distribution,mix,keys,ops,reps,warmup,cpu,seed,"
+           "min_ns_per_op,median_ns_per_op,mean_ns_per_op,max_ns_per_op,hits" << endl;
+    out << fixed << setprecision(2);
+    for (const auto& r : results) {
+        out << r.structure << "," << config.type << "," << config.dist << "," << config.mix << ","
+            << config.keys << "," << config.ops << "," << config.reps << "," << config.warmup << ","
+            << config.cpu << "," << config.seed << "," << r.minNs << "," << r.medianNs << "," << r.meanNs << ","
+            << r.maxNs << "," << r.hits << endl;
+    }
+}
+
+void writeJson(ostream& out, const Config& config, const vector<Result>& results) {
+    out << fixed << setprecision(2);
+    out << "{\n  \"config\": {"
+        << "\"key_type\": " << jsonQuote(config.type) << ", \"distribution\": " << jsonQuote(config.dist)
+        << ", \"mix\": " << jsonQuote(config.mix) << ", \"keys\": " << config.keys
+        << ", \"ops\": " << config.ops << ", \"reps\": " << config.reps << ", \"warmup\": " << config.warmup
+        << ", \"cpu\": " << config.cpu << ", \"seed\": " << config.seed << "},\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << (i ? "," : "") << "\n    {\"structure\": " << jsonQuote(r.structure)
+            << ", \"min_ns_per_op\": " << r.minNs << ", \"median_ns_per_op\": " << r.medianNs
+            << ", \"mean_ns_per_op\": " << r.meanNs << ", \"max_ns_per_op\": " << r.maxNs
+            << ", \"hits\": " << r.hits << "}";
+    }
+    out << "\n  ]\n}" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    Config config;
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (i + 1 >= argc) throw invalid_argument("选项缺少参数: " + arg);
+            string value = argv[++i];
+            if (arg == "--keys") config.keys = stoul(value);
+            else if (arg == "--ops") config.ops = stoul(value);
+            else if (arg == "--type") config.type = value;
+            else if (arg == "--dist") config.dist = value;
+            else if (arg == "--mix") config.mix = value;
+            else if (arg == "--reps") config.reps = max(1, stoi(value));
+            else if (arg == "--warmup") config.warmup = max(0, stoi(value));
+            else if (arg == "--cpu") config.cpu = stoi(value);
+            else if (arg == "--format") config.format = value;
+            else if (arg == "--seed") config.seed = uint32_t(stoul(value));
+            else if (arg == "--only") {
+                size_t start = 0;
+                while (start <= value.size()) {
+                    size_t comma = value.find(',', start);
+                    if (comma == string::npos) comma = value.size();
+                    config.only.push_back(value.substr(start, comma - start));
+                    start = comma + 1;
+                }
+            } else {
+                throw invalid_argument("未知选项: " + arg);
+            }
+        }
+        if (config.keys == 0) throw invalid_argument("--keys 必须大于 0");
+        if (config.type != "int" && config.type != "string") throw invalid_argument("未知的键类型: " + config.type);
+        if (config.format != "csv" && config.format != "json") throw invalid_argument("未知的输出格式: " + config.format);
+
+        if (config.cpu >= 0 && !pinToCpu(config.cpu)) {
+            cerr << "无法绑定到 CPU " << config.cpu << "，继续运行但不绑定" << endl;
+            config.cpu = -1;
+        }
+
+        mt19937 gen(config.seed);
+        vector<Result> results;
+        if (config.type == "int") {
+            auto keys = makeIntKeys(config.keys, gen);
+            auto ops = makeOps(config, keys, gen);
+            results = runAll(config, keys, ops);
+        } else {
+            auto keys = makeStringKeys(config.keys, gen);
+            auto ops = makeOps(config, keys, gen);
+            results = runAll(config, keys, ops);
+        }
+
+        if (config.format == "json") writeJson(cout, config, results);
+        else writeCsv(cout, config, results);
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOKENIZER_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+/**
+ * 输入文件的内存映射
+ *
+ * 以 MAP_PRIVATE 方式映射整个文件：读取不经过用户态缓冲区，写入只修改进程私有的副本
+ * （写时复制），因此分词时可以就地转成小写而不影响磁盘上的文件。
+ * 没有 mmap 的平台（Windows）退回一次性读入内存。
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!file) return;
+        fallback.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(&fallback[0], fallback.size());
+        ptr = fallback.empty() ? nullptr : &fallback[0];
+        length = fallback.size();
+        opened = true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0) {
+            length = static_cast<size_t>(st.st_size);
+            if (length == 0) {
+                opened = true;
+            } else {
+                void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    ptr = static_cast<char*>(p);
+                    opened = true;
+                    ::madvise(p, length, MADV_SEQUENTIAL);// 顺序扫描，提示内核积极预读
+                } else {
+                    length = 0;
+                }
+            }
+        }
+        ::close(fd);// 映射建立后即可关闭文件描述符
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (ptr) ::munmap(ptr, length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return opened; }
+    char* data() { return ptr; }
+    const char* data() const { return ptr; }
+    size_t size() const { return length; }
+
+private:
+    char* ptr = nullptr;
+    size_t length = 0;
+    bool opened = false;
+#ifdef _WIN32
+    std::string fallback;
+#endif
+};
+
+/**
+ * 分词：连续的 ASCII 字母组成一个单词，其余字符都是分隔符（与 C locale 下的 isalpha 一致）
+ *
+ * 单词以 std::string_view 的形式指向输入缓冲区本身，分词过程不分配任何内存；
+ * 只有计数结构第一次遇到某个单词时才需要复制它。缓冲区必须在单词使用期间保持有效。
+ *
+ * x86 上按运行时检测到的 CPU 特性选择实现：
+ * - avx2：每次处理 32 字节
+ * - sse2：每次处理 16 字节（x86-64 的基线指令集，总是可用）
+ * - scalar：逐字节处理，作为其他平台的退路和正确性基准
+ * 向量实现一次判断整块字节是否为字母并就地转小写，再从字母位掩码中
+ * 用 ctz 逐个取出单词的起止位置，不在每个字节上分支。
+ */
+namespace tokenizer {
+
+// 无分支判断 ASCII 字母：大小写只差 0x20 这一位
+inline bool is_letter(char c) {
+    return static_cast<unsigned char>((static_cast<unsigned char>(c) | 0x20) - 'a') < 26;
+}
+
+enum class simd_level { scalar, sse2, avx2 };
+
+inline const char* level_name(simd_level level) {
+    switch (level) {
+        case simd_level::avx2: return "avx2";
+        case simd_level::sse2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+// 当前 CPU 支持的最快实现，只检测一次
+inline simd_level best_level() {
+#ifdef TOKENIZER_X86_SIMD
+    static const simd_level level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+        if (__builtin_cpu_supports("sse2")) return simd_level::sse2;
+        return simd_level::scalar;
+    }();
+    return level;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+namespace detail {
+
+// 跨块保存的分词状态：当前是否在单词中，以及单词的起点
+struct word_state {
+    char* start = nullptr;
+    bool in_word = false;
+};
+
+// 逐字节处理 [p, end)，向量实现用它处理不足一块的尾部
+template<typename F>
+void scan_scalar(char* p, char* end, word_state& st, F& emit) {
+    for (; p < end; p++) {
+        if (is_letter(*p)) {
+            *p |= 0x20;
+            if (!st.in_word) {
+                st.start = p;
+                st.in_word = true;
+            }
+        } else if (st.in_word) {
+            emit(std::string_view(st.start, static_cast<size_t>(p - st.start)));
+            st.in_word = false;
+        }
+    }
+}
+
+/**
+ * 处理一块的字母位掩码 mask（第 i 位为 1 表示 block[i] 是字母）
+ * 单词起点是"本位为字母且前一位不是"，终点是"本位不是字母且前一位是"，
+ * 前一块的最后一位通过 st.in_word 传入；起止位置交替出现，按位序依次取出
+ */
+template<typename Mask, typename F>
+inline void scan_mask(char* block, Mask mask, unsigned width, word_state& st, F& emit) {
+    // Mask 比块宽，移出块外的最高位不能算作终点
+    Mask prev = static_cast<Mask>((mask << 1) | (st.in_word ? 1 : 0));
+    Mask starts = mask & ~prev;
+    Mask ends = ~mask & prev & ((Mask(1) << width) - 1);
+    Mask events = starts | ends;
+    while (events) {
+        unsigned i = static_cast<unsigned>(__builtin_ctzll(events));
+        if ((starts >> i) & 1) {
+            st.start = block + i;
+        } else {
+            emit(std::string_view(st.start, static_cast<size_t>(block + i - st.start)));
+        }
+        events &= events - 1;
+    }
+    st.in_word = (mask >> (width - 1)) & 1;
+}
+
+#ifdef TOKENIZER_X86_SIMD
+template<typename F>
+__attribute__((target("sse2")))
+void scan_sse2(char* p, char* end, word_state& st, F& emit) {
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i a = _mm_set1_epi8('a');
+    const __m128i z = _mm_set1_epi8(25);
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // (c | 0x20) - 'a' 按无符号比较不超过 25 即为字母
+        __m128i offset = _mm_sub_epi8(_mm_or_si128(v, case_bit), a);
+        __m128i letters = _mm_cmpeq_epi8(_mm_min_epu8(offset, z), offset);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_or_si128(v, _mm_and_si128(letters, case_bit)));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(letters));
+        scan_mask(p, mask, 16, st, emit);
+    }
+    scan_scalar(p, end, st, emit);
+}
+
+template<typename F>
+__attribute__((target("avx2")))
+void scan_avx2(char* p, char* end, word_state& st, F& emit) {
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i a = _mm256_set1_epi8('a');
+    const __m256i z = _mm256_set1_epi8(25);
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i offset = _mm256_sub_epi8(_mm256_or_si256(v, case_bit), a);
+        __m256i letters = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, z), offset);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_or_si256(v, _mm256_and_si256(letters, case_bit)));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(letters));
+        scan_mask(p, static_cast<uint64_t>(mask), 32, st, emit);
+    }
+    scan_scalar(p, end, st, emit);
+}
+#endif
+
+} // namespace detail
+
+/**
+ * 对 [begin, end) 中的每个单词调用 emit(std::string_view) - 时间复杂度: O(n)
+ * 单词就地转成小写，所以缓冲区必须可写；level 指定实现，各实现的输出逐字节相同
+ */
+template<typename F>
+void for_each_word(char* begin, char* end, F&& emit, simd_level level) {
+    detail::word_state st;
+    switch (level) {
+#ifdef TOKENIZER_X86_SIMD
+        case simd_level::avx2: detail::scan_avx2(begin, end, st, emit); break;
+        case simd_level::sse2: detail::scan_sse2(begin, end, st, emit); break;
+#endif
+        default: detail::scan_scalar(begin, end, st, emit); break;
+    }
+    if (st.in_word) emit(std::string_view(st.start, static_cast<size_t>(end - st.start)));
+}
+
+// 使用当前 CPU 上最快的实现
+template<typename F>
+void for_each_word(char* begin, char* end, F&& emit) {
+    for_each_word(begin, end, emit, best_level());
+}
+
+/**
+ * 从流中分块读取并分词 - 时间复杂度: O(n)，额外空间 O(buffer_size)
+ * 每次读满固定大小的缓冲区，只处理到最后一个分隔符为止；末尾未结束的单词搬到缓冲区开头，
+ * 与下一次读到的数据拼接，所以无论读取在哪里截断，切出的单词都与整体分词相同。
+ * 管道和标准输入可能只读到一部分数据，此时继续读而不是截断单词；
+ * 只有长于整个缓冲区的字母串才会被按缓冲区大小切开。
+ * 单词的 string_view 只在 emit 调用期间有效，需要保存时由调用者复制。
+ * @return 读到的总字节数，读取出错时在出错处停止（调用者可用 ferror 检查）
+ */
+template<typename F>
+size_t for_each_word_in_stream(std::FILE* in, size_t buffer_size, F&& emit) {
+    if (buffer_size == 0) buffer_size = 1;
+    std::vector<char> buffer(buffer_size);
+    char* buf = buffer.data();
+    size_t carry = 0, total = 0;
+    while (true) {
+        size_t n = std::fread(buf + carry, 1, buffer_size - carry, in);
+        total += n;
+        size_t filled = carry + n;
+        if (n == 0) {// 读到末尾，剩下的就是最后一个单词
+            for_each_word(buf, buf + filled, emit);
+            return total;
+        }
+
+        size_t end = filled;
+        while (end > 0 && is_letter(buf[end - 1])) end--;
+        if (end == 0) {
+            if (filled < buffer_size) {// 还没读满，继续拼接
+                carry = filled;
+                continue;
+            }
+            end = filled;
+        }
+        for_each_word(buf, buf + end, emit);
+        carry = filled - end;
+        std::memmove(buf, buf + end, carry);
+    }
+}
+
+/**
+ * 把 [0, size) 切成 parts 块，返回 parts + 1 个分块点 - 时间复杂度: O(parts × 最长单词)
+ * 分块点落在单词中间时向后挪到单词结束处，保证每个单词完整地属于某一块
+ */
+inline std::vector<size_t> split_on_words(const char* data, size_t size, unsigned parts) {
+    if (parts == 0) parts = 1;
+    std::vector<size_t> cut(parts + 1, size);
+    cut[0] = 0;
+    for (unsigned t = 1; t < parts; t++) {
+        size_t pos = size * t / parts;
+        if (pos < cut[t - 1]) pos = cut[t - 1];
+        while (pos > 0 && pos < size && is_letter(data[pos - 1]) && is_letter(data[pos])) pos++;
+        cut[t] = pos;
+    }
+    return cut;
+}
+
+} // namespace tokenizer
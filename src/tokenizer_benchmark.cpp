@@ -0,0 +1,113 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include "tokenizer.h"
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * 分词器正确性校验与吞吐量测试
+ *
+ * 用法: tokenizer_benchmark [输入文件] [目标大小MB]
+ *   1. 随机字节校验：各种长度、各种对齐、包含大小写字母和 0x80 以上的字节，
+ *      每种向量实现转小写后的缓冲区和切出的单词都必须与逐字节实现完全一致
+ *   2. 吞吐量：把输入文件在内存中重复拼接到目标大小，测量各实现的 GB/秒
+ */
+
+struct TokenizeResult {
+    string buffer;               // 转小写之后的缓冲区
+    vector<pair<size_t, size_t>> words;  // (偏移, 长度)
+};
+
+TokenizeResult tokenize(const string& input, tokenizer::simd_level level) {
+    TokenizeResult r{input, {}};
+    char* base = &r.buffer[0];
+    tokenizer::for_each_word(base, base + r.buffer.size(), [&](string_view w) {
+        r.words.push_back({size_t(w.data() - base), w.size()});
+    }, level);
+    return r;
+}
+
+vector<tokenizer::simd_level> availableLevels() {
+    vector<tokenizer::simd_level> levels{tokenizer::simd_level::scalar};
+    auto best = tokenizer::best_level();
+    if (best >= tokenizer::simd_level::sse2) levels.push_back(tokenizer::simd_level::sse2);
+    if (best >= tokenizer::simd_level::avx2) levels.push_back(tokenizer::simd_level::avx2);
+    return levels;
+}
+
+bool validate() {
+    mt19937 gen(37);
+    // 字母较多、分隔符较少时单词会跨块，两者都有时边界最多
+    const string alphabet = "abcXYZqQ \n\t,.-'09\x80\xff\xc3\xa9@[`{";
+    auto levels = availableLevels();
+    size_t cases = 0;
+    for (size_t len = 0; len < 300; len++) {
+        for (int round = 0; round < 20; round++) {
+            string input(len + 7, '\0');
+            for (auto& c : input) c = alphabet[gen() % alphabet.size()];
+            // 不同的起始偏移覆盖各种对齐
+            string sliced = input.substr(round % 7, len);
+            TokenizeResult expected = tokenize(sliced, tokenizer::simd_level::scalar);
+            for (auto level : levels) {
+                TokenizeResult actual = tokenize(sliced, level);
+                if (actual.buffer != expected.buffer || actual.words != expected.words) {
+                    cout << "校验失败: " << tokenizer::level_name(level) << ", 长度 " << len << endl;
+                    return false;
+                }
+            }
+            cases++;
+        }
+    }
+    cout << "随机字节校验通过: " << cases << " 组输入, 实现 ";
+    for (auto level : levels) cout << tokenizer::level_name(level) << " ";
+    cout << endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    string path = argc > 1 ? argv[1] : "../data/test.txt";
+    size_t targetMB = argc > 2 ? stoul(argv[2]) : 256;
+
+    if (!validate()) return 1;
+
+    MappedFile file(path);
+    if (!file.is_open() || file.size() == 0) {
+        cout << "Error: 无法读取文件或文件为空" << endl;
+        return 1;
+    }
+    string corpus;
+    corpus.reserve(targetMB << 20);
+    while (corpus.size() + file.size() <= (targetMB << 20)) corpus.append(file.data(), file.size());
+    if (corpus.empty()) corpus.assign(file.data(), file.size());
+
+    cout << "当前 CPU 选择: " << tokenizer::level_name(tokenizer::best_level()) << endl;
+    cout << "输入 " << corpus.size() / double(1 << 20) << " MB" << endl;
+    cout << "实现\t耗时(ms)\tGB/秒\t单词数\t与逐字节一致" << endl;
+    cout << fixed << setprecision(2);
+
+    TokenizeResult reference = tokenize(corpus, tokenizer::simd_level::scalar);
+    for (auto level : availableLevels()) {
+        // 每轮都从原始大小写的副本开始，计时只包含分词本身
+        string buffer = corpus;
+        size_t words = 0, checksum = 0;
+        char* base = &buffer[0];
+        auto start = high_resolution_clock::now();
+        tokenizer::for_each_word(base, base + buffer.size(), [&](string_view w) {
+            words++;
+            checksum += size_t(w.data() - base) ^ w.size();
+        }, level);
+        auto end = high_resolution_clock::now();
+        double ns = double(duration_cast<nanoseconds>(end - start).count());
+
+        size_t expectedChecksum = 0;
+        for (auto& [off, len] : reference.words) expectedChecksum += off ^ len;
+        bool same = buffer == reference.buffer && words == reference.words.size() && checksum == expectedChecksum;
+        cout << tokenizer::level_name(level) << "\t" << ns / 1e6 << "\t\t" << buffer.size() / ns << "\t"
+             << words << "\t" << (same ? "是" : "否") << endl;
+    }
+    return 0;
+}
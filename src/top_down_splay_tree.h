@@ -0,0 +1,342 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+#include "node_pool.h"
+
+/**
+ * 自顶向下伸展树（Sleator–Tarjan）
+ *
+ * 与 SplayTree 的自底向上伸展不同，这里在沿查找路径下降的同时完成伸展：
+ * 路径上比目标小的节点挂到左树，比目标大的挂到右树，到达目标后再把
+ * 左右两棵树接到目标节点下面。整个访问只需一趟，不需要 parent 指针，
+ * 因此每个节点少 8 字节，每次旋转需要改写的指针也更少。
+ *
+ * 节点同样记录子树大小：下降时累计左右两棵树的节点数，组装前沿左树的右链、
+ * 右树的左链各走一遍改正大小，代价与伸展路径同阶，split 因此不必数节点。
+ *
+ * 接口与 SplayTree 一致：insert/find/erase/split/merge
+ */
+template<typename T, typename Comp = std::less<T>>
+class TopDownSplayTree {
+public:
+    struct node {
+        node *left = nullptr;
+        node *right = nullptr;
+        size_t size = 1;// 以该节点为根的子树大小，伸展时维护
+        T key;
+
+        explicit node(const T& k) : key(k) {}
+    };
+
+private:
+    static NodePool<node> node_pool;
+
+    static size_t subtree_size(const node* x) { return x ? x->size : 0; }
+
+    static node* allocate_node(const T& key) {
+        return node_pool.allocate(key);
+    }
+
+    static void deallocate_node(node* n) {
+        node_pool.deallocate(n);
+    }
+
+public:
+    // 基本属性
+    Comp comp;
+    unsigned long p_size;// 节点数量
+    node* root;
+
+    TopDownSplayTree() : p_size(0), root(nullptr) {}
+
+    TopDownSplayTree(const TopDownSplayTree& other)
+        : comp(other.comp), p_size(other.p_size), root(copy_tree(other.root)) {}
+
+    TopDownSplayTree(TopDownSplayTree&& other) noexcept
+        : comp(other.comp), p_size(other.p_size), root(other.root) {
+        other.root = nullptr;
+        other.p_size = 0;
+    }
+
+    TopDownSplayTree& operator=(const TopDownSplayTree& other) {
+        if (this != &other) {
+            clear(root);
+            comp = other.comp;
+            root = copy_tree(other.root);
+            p_size = other.p_size;
+        }
+        return *this;
+    }
+
+    TopDownSplayTree& operator=(TopDownSplayTree&& other) noexcept {
+        if (this != &other) {
+            clear(root);
+            comp = std::move(other.comp);
+            root = other.root;
+            p_size = other.p_size;
+            other.root = nullptr;
+            other.p_size = 0;
+        }
+        return *this;
+    }
+
+    ~TopDownSplayTree() {
+        clear(root);
+        root = nullptr;
+        p_size = 0;
+    }
+
+    /**
+     * 插入操作 - 时间复杂度: 平摊 O(log n)
+     * 先把最接近 key 的节点伸展到根，再把新节点放到根上，原根按大小挂到左边或右边
+     */
+    void insert(const T &key) {
+        if (!root) {
+            root = allocate_node(key);
+            p_size++;
+            return;
+        }
+
+        root = splay(key, root);
+        if (!comp(key, root->key) && !comp(root->key, key)) return;// 已存在
+
+        node* z = allocate_node(key);
+        if (comp(key, root->key)) {
+            z->left = root->left;
+            z->right = root;
+            root->left = nullptr;
+            root->size = 1 + subtree_size(root->right);
+        } else {
+            z->right = root->right;
+            z->left = root;
+            root->right = nullptr;
+            root->size = 1 + subtree_size(root->left);
+        }
+        z->size = 1 + subtree_size(z->left) + subtree_size(z->right);
+        root = z;
+        p_size++;
+    }
+
+    /**
+     * 查找操作 - 时间复杂度: 平摊 O(log n)
+     * 无论是否找到，最后访问的节点都会成为根
+     */
+    node* find(const T &key) {
+        if (!root) return nullptr;
+        root = splay(key, root);
+        if (comp(key, root->key) || comp(root->key, key)) return nullptr;
+        return root;
+    }
+
+    /**
+     * 删除操作 - 时间复杂度: 平摊 O(log n)
+     * 目标伸展到根后，把左子树中的最大值伸展上来作为新根，再接上右子树
+     */
+    void erase(const T &key) {
+        if (!find(key)) return;
+
+        node* target = root;
+        if (!target->left) {
+            root = target->right;
+        } else {
+            // 左子树中所有键都小于 key，伸展后的根没有右孩子
+            root = splay(key, target->left);
+            root->right = target->right;
+            root->size += subtree_size(target->right);
+        }
+        deallocate_node(target);
+        p_size--;
+    }
+
+    /**
+     * 树的拆分操作 - 时间复杂度: 平摊 O(log n)
+     * 左树中所有键值小于等于 key，右树中所有键值大于 key
+     */
+    std::pair<TopDownSplayTree*, TopDownSplayTree*> split(const T& key) {
+        auto* left = new TopDownSplayTree();
+        auto* right = new TopDownSplayTree();
+        left->comp = right->comp = comp;
+        if (!root) return {left, right};
+
+        root = splay(key, root);
+        if (!comp(key, root->key)) {// key >= root->key
+            left->root = root;
+            right->root = root->right;
+            root->right = nullptr;
+            root->size -= subtree_size(right->root);
+        } else {
+            right->root = root;
+            left->root = root->left;
+            root->left = nullptr;
+            root->size -= subtree_size(left->root);
+        }
+
+        left->p_size = subtree_size(left->root);
+        right->p_size = p_size - left->p_size;
+
+        root = nullptr;
+        p_size = 0;
+        return {left, right};
+    }
+
+    /**
+     * 树的合并操作 - 时间复杂度: 平摊 O(log n)
+     * 前提是 t1 中的所有键值必须小于 t2 中的所有键值，否则返回 nullptr
+     */
+    static TopDownSplayTree* merge(TopDownSplayTree* t1, TopDownSplayTree* t2) {
+        auto* result = new TopDownSplayTree();
+        if (!t1 || !t1->root || !t2 || !t2->root) {
+            TopDownSplayTree* src = (t1 && t1->root) ? t1 : t2;
+            if (src) *result = std::move(*src);
+            delete t1;
+            delete t2;
+            return result;
+        }
+
+        // 伸展 t1 的最大值、t2 的最小值到各自的根
+        node* max_node = t1->root;
+        while (max_node->right) max_node = max_node->right;
+        t1->root = t1->splay(max_node->key, t1->root);
+        node* min_node = t2->root;
+        while (min_node->left) min_node = min_node->left;
+        t2->root = t2->splay(min_node->key, t2->root);
+
+        if (!t1->comp(t1->root->key, t2->root->key)) {
+            delete result;
+            delete t1;
+            delete t2;
+            return nullptr;
+        }
+
+        t1->root->right = t2->root;
+        t1->root->size += t2->root->size;
+        result->comp = t1->comp;
+        result->root = t1->root;
+        result->p_size = t1->p_size + t2->p_size;
+
+        t1->root = t2->root = nullptr;
+        t1->p_size = t2->p_size = 0;
+        delete t1;
+        delete t2;
+        return result;
+    }
+
+    // 释放以 x 为根的子树：把左孩子不断右旋上来，树被压成右链后逐个释放，额外空间 O(1)
+    // 节点马上被释放，旋转时不维护 size
+    void clear(node *x) {
+        while (x) {
+            if (x->left) {
+                node* l = x->left;
+                x->left = l->right;
+                l->right = x;
+                x = l;
+            } else {
+                node* next = x->right;
+                deallocate_node(x);
+                x = next;
+            }
+        }
+    }
+
+    bool empty() const { return root == nullptr; }
+    unsigned long size() const { return p_size; }
+
+    static size_t get_current_nodes() { return node_pool.current_nodes(); }
+    static size_t get_bytes_in_use() { return node_pool.bytes_in_use(); }
+
+private:
+    /**
+     * 自顶向下伸展 - 时间复杂度: 平摊 O(log n)
+     * 返回新的根：若 key 存在则为该节点，否则为查找路径上最后访问的节点
+     *
+     * l_hook 指向左树中最大节点的右指针，r_hook 指向右树中最小节点的左指针，
+     * 下降时把节点挂到对应的钩子上即可，不需要回溯。
+     * l_size / r_size 累计左右两棵树的节点数，挂上去的节点的 size 最后再改正
+     */
+    node* splay(const T& key, node* t) {
+        node* l = nullptr;
+        node* r = nullptr;
+        node** l_hook = &l;
+        node** r_hook = &r;
+        size_t l_size = 0, r_size = 0;
+
+        for (;;) {
+            if (comp(key, t->key)) {
+                if (!t->left) break;
+                if (comp(key, t->left->key)) {// Zig-Zig：先右旋
+                    node* y = t->left;
+                    t->left = y->right;
+                    y->right = t;
+                    t->size = 1 + subtree_size(t->left) + subtree_size(t->right);
+                    t = y;
+                    if (!t->left) break;
+                }
+                // 挂到右树
+                *r_hook = t;
+                r_hook = &t->left;
+                r_size += 1 + subtree_size(t->right);
+                t = t->left;
+            } else if (comp(t->key, key)) {
+                if (!t->right) break;
+                if (comp(t->right->key, key)) {// Zag-Zag：先左旋
+                    node* y = t->right;
+                    t->right = y->left;
+                    y->left = t;
+                    t->size = 1 + subtree_size(t->left) + subtree_size(t->right);
+                    t = y;
+                    if (!t->right) break;
+                }
+                // 挂到左树
+                *l_hook = t;
+                l_hook = &t->right;
+                l_size += 1 + subtree_size(t->left);
+                t = t->right;
+            } else {
+                break;
+            }
+        }
+
+        // 改正大小：左树右链上的节点依次减去自身和左子树，右树左链对称
+        l_size += subtree_size(t->left);
+        r_size += subtree_size(t->right);
+        t->size = l_size + r_size + 1;
+        *l_hook = *r_hook = nullptr;
+        for (node* y = l; y; y = y->right) {
+            y->size = l_size;
+            l_size -= 1 + subtree_size(y->left);
+        }
+        for (node* y = r; y; y = y->left) {
+            y->size = r_size;
+            r_size -= 1 + subtree_size(y->right);
+        }
+
+        // 重新组装
+        *l_hook = t->left;
+        *r_hook = t->right;
+        t->left = l;
+        t->right = r;
+        return t;
+    }
+
+    // 用显式栈复制子树，避免退化成链时递归过深
+    node* copy_tree(node* src) {
+        if (!src) return nullptr;
+        node* result = nullptr;
+        std::vector<std::pair<node*, node**>> stack{{src, &result}};
+        while (!stack.empty()) {
+            auto [from, slot] = stack.back();
+            stack.pop_back();
+            node* n = allocate_node(from->key);
+            n->size = from->size;
+            *slot = n;
+            if (from->left) stack.push_back({from->left, &n->left});
+            if (from->right) stack.push_back({from->right, &n->right});
+        }
+        return result;
+    }
+};
+
+template<typename T, typename Comp>
+NodePool<typename TopDownSplayTree<T, Comp>::node> TopDownSplayTree<T, Comp>::node_pool;
@@ -2,13 +2,34 @@
 #include <fstream>
 #include <unordered_map>
 #include <chrono>
-#include <cctype>
 #include <algorithm>
 #include <iomanip>
 #include <numeric>  
 #include <cmath>   
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include "bulk_build.h"
+#include "count_min_sketch.h"
+#include "key_prefix.h"
+#include "latency_histogram.h"
+#include "node_pool.h"
+#include "perf_counters.h"
+#include "splay_policy.h"
+#include "string_arena.h"
+#include "tokenizer.h"
+#include "word_frequency.h"
+#include "zipf_generator.h"
 using namespace std;
 using namespace std::chrono;
+using namespace word_frequency;
 
 /**
  * 伸展树词频统计与性能测试程序
@@ -24,487 +45,434 @@ using namespace std::chrono;
  * - 树结构特性（平均深度）的比较
  */
 
-// 增加缓冲区大小，提高文件读取效率
-const int BUFFER_SIZE = 8192;
 
 /**
- * 伸展树节点定义
- * 包含键值、计数、左右子节点和父节点指针
+ * 文本处理：对映射到内存的输入分词 - 时间复杂度: O(n)
+ * 单词就地转为小写，返回的 string_view 直接指向 input 的缓冲区，不为每个单词分配内存；
+ * input 必须在这些单词使用期间保持有效
  */
-struct Node {
-    string key;        // 单词
-    int count = 1;     // 出现次数
-    Node* left = nullptr;    // 左子节点
-    Node* right = nullptr;   // 右子节点
-    Node* parent = nullptr;  // 父节点（用于伸展操作）
-
-    Node(const string& k) : key(k) {}
-};
+vector<string_view> processFile(MappedFile& input) {
+    vector<string_view> words;
+    words.reserve(input.size() / 8);  // 按平均每词约 8 字节预分配
+    tokenizer::for_each_word(input.data(), input.data() + input.size(),
+                             [&](string_view word) { words.push_back(word); });
+    return words;
+}
 
-class SplayTree {
-private:
-    Node* root = nullptr;
-    int operationCount = 0;    // 记录旋转操作次数，用于性能分析
-    int totalOperations = 0;   // 用于控制伸展频率
-    static const int SPLAY_THRESHOLD = 100;  // 伸展阈值，每100次操作才进行一次伸展，减少开销
-
-    /**
-     * 条件伸展操作 - 优化策略
-     * 不是每次访问都伸展，而是每SPLAY_THRESHOLD次操作才伸展一次
-     * 这样可以减少频繁旋转带来的开销，同时保持伸展树的自调整特性
-     * 
-     * @param x 需要考虑伸展的节点
-     */
-    void conditionalSplay(Node* x) {
-        totalOperations++;
-        if (totalOperations % SPLAY_THRESHOLD == 0) {
-            splay(x);
-        }
+// 随机单词生成函数
+string generateRandomWord(int len) {
+    static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
+    string word;
+    for (int i = 0; i < len; ++i) {
+        word += charset[rand() % 26];
     }
+    return word;
+}
 
-    /**
-     * 伸展操作 - 将节点x旋转到根部位置
-     * 通过一系列旋转，使得被访问的节点成为树的根节点
-     * 时间复杂度: 平摊O(log n)
-     * 
-     * @param x 需要伸展到根部的节点
-     */
-    void splay(Node* x) {
-        if (!x) return;
-
-        while (x->parent) {
-            Node* p = x->parent;
-            Node* g = p->parent;
-
-            if (!g) {
-                singleRotate(x);
-            } else {
-                doubleRotate(x);
-            }
-        }
-        root = x;
-    }
+/**
+ * 排序聚合：把单词序列排序后合并相同的单词 - 时间复杂度: O(n log n)
+ * 只对 string_view 排序，不复制字符串；结果按单词升序排列，可直接用于 buildFromSorted
+ */
+vector<pair<string_view, long long>> aggregateSorted(vector<string_view> words) {
+    sort(words.begin(), words.end());
 
-    /**
-     * 单旋转优化 - 处理父节点是根的情况
-     * 对应Zig或Zag操作
-     * 时间复杂度: O(1)
-     * 
-     * @param x 需要旋转的节点
-     */
-    void singleRotate(Node* x) {
-        Node* p = x->parent;
-        if (x == p->left) {
-            rotateRight(p);
-        } else {
-            rotateLeft(p);
-        }
+    vector<pair<string_view, long long>> result;
+    for (string_view word : words) {
+        if (word.empty()) continue;
+        if (!result.empty() && result.back().first == word) result.back().second++;
+        else result.push_back({word, 1});
     }
+    return result;
+}
 
-    /**
-     * 双旋转优化 - 处理父节点不是根的情况
-     * 对应Zig-Zig、Zig-Zag、Zag-Zig、Zag-Zag四种情况
-     * 时间复杂度: O(1)
-     * 
-     * @param x 需要旋转的节点
-     */
-    void doubleRotate(Node* x) {
-        Node* p = x->parent;
-        Node* g = p->parent;
-        
-        if (x == p->left && p == g->left) {
-            rotateRight(g);
-            rotateRight(p);
-        } else if (x == p->right && p == g->right) {
-            rotateLeft(g);
-            rotateLeft(p);
-        } else if (x == p->right && p == g->left) {
-            rotateLeft(p);
-            rotateRight(g);
+/**
+ * 并行分块统计 - 时间复杂度: O(n log d / T + d log T)，n 为单词数，d 为不同单词数，T 为线程数
+ * 1. 按单词边界把输入切成 threads 块，分块点落在单词中间时向后挪到单词结束处
+ * 2. 每个线程在自己的树中统计一块（每棵树有自己的内存池，线程之间不共享可变状态），
+ *    完成后中序导出为有序的(单词, 次数)序列
+ * 3. 多路归并各线程的序列，相同单词的次数相加，再线性时间构建结果树
+ */
+void countParallel(MappedFile& input, unsigned threads, SplayTree<>& result) {
+    threads = max(1u, threads);
+    char* data = input.data();
+    vector<size_t> cut = tokenizer::split_on_words(data, input.size(), threads);
+
+    vector<vector<pair<string, long long>>> parts(threads);
+    auto countChunk = [&](unsigned t) {
+        // 各线程的块互不重叠，就地转小写不会互相干扰
+        SplayTree<> local;
+        tokenizer::for_each_word(data + cut[t], data + cut[t + 1],
+                                 [&](string_view word) { local.insertWithoutSplay(word); });
+        local.traverse(local.getRoot(), parts[t]);
+    };
+
+    vector<thread> workers;
+    for (unsigned t = 1; t < threads; t++) workers.emplace_back(countChunk, t);
+    countChunk(0);
+    for (auto& w : workers) w.join();
+
+    // 多路归并：堆顶为当前最小的单词所在的序列
+    vector<size_t> pos(threads, 0);
+    auto later = [&](unsigned a, unsigned b) { return parts[a][pos[a]].first > parts[b][pos[b]].first; };
+    priority_queue<unsigned, vector<unsigned>, decltype(later)> heap(later);
+    for (unsigned t = 0; t < threads; t++) {
+        if (!parts[t].empty()) heap.push(t);
+    }
+
+    vector<pair<string, long long>> merged;
+    while (!heap.empty()) {
+        unsigned t = heap.top();
+        heap.pop();
+        auto& entry = parts[t][pos[t]];
+        if (!merged.empty() && merged.back().first == entry.first) {
+            merged.back().second += entry.second;
         } else {
-            rotateRight(p);
-            rotateLeft(g);
+            merged.push_back(std::move(entry));
         }
+        if (++pos[t] < parts[t].size()) heap.push(t);
     }
 
-    /**
-     * 左旋转操作 - 时间复杂度: O(1)
-     * 将节点x的右子节点y提升为其位置，x变为y的左子节点
-     * 
-     *    x          y
-     *   / \        / \
-     *  a   y  =>  x   c
-     *     / \    / \
-     *    b   c  a   b
-     * 
-     * @param x 需要左旋的节点
-     */
-    void rotateLeft(Node* x) {
-        Node* y = x->right;
-        operationCount++;
-        
-        x->right = y->left;
-        if (y->left) y->left->parent = x;
-        
-        y->parent = x->parent;
-        if (!x->parent) root = y;
-        else if (x == x->parent->left) x->parent->left = y;
-        else x->parent->right = y;
-        
-        y->left = x;
-        x->parent = y;
-    }
-
-    /**
-     * 右旋转操作 - 时间复杂度: O(1)
-     * 将节点x的左子节点y提升为其位置，x变为y的右子节点
-     * 
-     *    x          y
-     *   / \        / \
-     *  y   c  =>  a   x
-     * / \            / \
-     *a   b          b   c
-     * 
-     * @param x 需要右旋的节点
-     */
-    void rotateRight(Node* x) {
-        Node* y = x->left;
-        operationCount++;
-        
-        x->left = y->right;
-        if (y->right) y->right->parent = x;
-        
-        y->parent = x->parent;
-        if (!x->parent) root = y;
-        else if (x == x->parent->right) x->parent->right = y;
-        else x->parent->left = y;
-        
-        y->right = x;
-        x->parent = y;
-    }
+    result.buildFromSorted(merged.begin(), merged.end());
+}
 
-    // 添加计算平均深度的方法
-    int totalDepth = 0;
-    int nodeCount = 0;
-    int compareCount = 0;  // 添加比较次数计数器
-    int accessCount = 0;   // 添加访问计数器
+// 输出总词数、不同单词数以及前20个单词，top 已按出现次数降序排列（即 SplayTree::topK 的结果）
+void writeFrequencies(ostream& out, long long totalWords, size_t distinct, const vector<pair<string, long long>>& top) {
+    out << "=== 词频统计结果 ===" << endl;
+    out << "总单词数：" << totalWords << endl;
+    out << "不同单词数：" << distinct << endl << endl;
     
-    void calculateDepth(Node* node, int depth) {
-        if (!node) return;
-        totalDepth += depth;
-        nodeCount++;
-        calculateDepth(node->left, depth + 1);
-        calculateDepth(node->right, depth + 1);
-    }
-
-    void deleteTree(Node* node) {
-        if (node) {
-            deleteTree(node->left);
-            deleteTree(node->right);
-            delete node;
-        }
+    out << "词频排序（前20个）：" << endl;
+    out << "单词\t\t出现次数\t占比" << endl;
+    out << "----------------------------------------" << endl;
+    
+    for (int i = 0; i < min(20, (int)top.size()); i++) {
+        const auto& freq = top[i];
+        double percentage = (freq.second * 100.0) / totalWords;
+        out << freq.first << "\t\t" 
+            << freq.second << "\t\t"
+            << fixed << setprecision(2) << percentage << "%" << endl;
     }
+}
 
-public:
-    // 插入并伸展
-    void insert(const string& key) {
-        accessCount++;
-        Node* current = root;
-        Node* parent = nullptr;
-
-        // 查找插入位置
-        while (current) {
-            compareCount++;
-            parent = current;
-            if (key < current->key) {
-                current = current->left;
-            } else if (key > current->key) {
-                current = current->right;
-            } else {
-                current->count++;
-                splay(current);
-                return;
-            }
-        }
-
-        // 新建节点
-        Node* newNode = new Node(key);
-        newNode->parent = parent;
-
-        if (!parent) root = newNode;
-        else if (key < parent->key) parent->left = newNode;
-        else parent->right = newNode;
-
-        splay(newNode);
+/**
+ * 并行模式：线程数从 1 开始翻倍直到 maxThreads，测量分块统计的耗时和加速比，
+ * 并校验每种线程数得到的词频与单线程完全一致。输入只映射一次，适用于 GB 级的文件
+ */
+int runParallel(const string& inputPath, unsigned maxThreads) {
+    MappedFile input(inputPath);
+    if (!input.is_open() || input.size() == 0) {
+        cout << "Error: 无法读取文件或文件为空" << endl;
+        return 1;
     }
+    cout << "并行分块统计开始..." << endl;
+    cout << "输入大小: " << input.size() << " 字节" << endl;
 
-    // 批量插入方法
-    void batchInsert(const vector<string>& words) {
-        if (words.empty()) return;
-        
-        for (const auto& word : words) {
-            if (!word.empty()) {
-                insertWithoutSplay(word);
-            }
-        }
+    vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
 
-        // 最后进行一次平衡，添加空指针检查
-        if (root && getSize(root) > 0) {
-            Node* mid = findMid(root);
-            if (mid) {
-                splay(mid);
+    const int TEST_ITERATIONS = 3;
+    vector<pair<string, long long>> reference, top;
+    long long totalWords = 0;
+    vector<pair<unsigned, double>> timings;  // (线程数, 最短耗时 毫秒)
+    bool consistent = true;
+    for (unsigned threads : threadCounts) {
+        double best = 0;
+        for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+            SplayTree<> tree;
+            auto start = high_resolution_clock::now();
+            countParallel(input, threads, tree);
+            auto end = high_resolution_clock::now();
+            double ms = duration_cast<microseconds>(end - start).count() / 1000.0;
+            if (iter == 0 || ms < best) best = ms;
+
+            if (iter == 0) {
+                vector<pair<string, long long>> frequencies;
+                tree.traverse(tree.getRoot(), frequencies);
+                if (reference.empty()) {
+                    reference = std::move(frequencies);
+                    totalWords = tree.getTotalCount();
+                    top = tree.topK();
+                } else {
+                    consistent &= frequencies == reference && tree.topK() == top;
+                }
             }
         }
+        timings.push_back({threads, best});
+        cout << "线程数 " << threads << ": " << fixed << setprecision(2) << best << " 毫秒" << endl;
     }
 
-    // 不立即伸展的插入
-    void insertWithoutSplay(const string& key) {
-        Node* current = root;
-        Node* parent = nullptr;
-
-        while (current) {
-            parent = current;
-            if (key < current->key) {
-                current = current->left;
-            } else if (key > current->key) {
-                current = current->right;
-            } else {
-                current->count++;
-                conditionalSplay(current);
-                return;
-            }
-        }
-
-        Node* newNode = new Node(key);
-        newNode->parent = parent;
+    ofstream outFile("../data/result.txt");
+    writeFrequencies(outFile, totalWords, reference.size(), top);
 
-        if (!parent) {
-            root = newNode;
-        } else if (key < parent->key) {
-            parent->left = newNode;
-        } else {
-            parent->right = newNode;
-        }
-
-        conditionalSplay(newNode);
+    outFile << "\n=== 并行分块统计 ===" << endl;
+    outFile << "输入大小: " << input.size() << " 字节, 硬件线程数: " << thread::hardware_concurrency() << endl;
+    outFile << "线程数\t耗时(毫秒)\t吞吐(MB/秒)\t加速比" << endl;
+    for (const auto& [threads, ms] : timings) {
+        outFile << threads << "\t" << fixed << setprecision(2) << ms << "\t\t"
+                << input.size() / (ms / 1000.0) / 1e6 << "\t\t"
+                << timings.front().second / ms << endl;
     }
+    outFile << "各线程数结果一致: " << (consistent ? "是" : "否") << endl;
 
-    // 找到中间节点用于平衡
-    Node* findMid(Node* node) {
-        if (!node) return nullptr;
-        
-        int size = getSize(node);
-        int target = size / 2;
-        
-        return findKthNode(node, target);
-    }
+    cout << "\n测试完成！详细结果已保存到 ../data/result.txt" << endl;
+    return consistent ? 0 : 1;
+}
 
-    // 获取子树大小
-    int getSize(Node* node) {
-        if (!node) return 0;
-        return 1 + getSize(node->left) + getSize(node->right);
-    }
+// 流式统计的读缓冲区大小
+const size_t STREAM_BUFFER_SIZE = 1 << 20;
+// 流式统计每处理这么多个单词，在标准错误上报告一次当前的最高频单词
+const long long STREAM_REPORT_WORDS = 1 << 24;
 
-    // 找到第k个节点
-    Node* findKthNode(Node* node, int k) {
-        if (!node) return nullptr;
-        
-        int leftSize = getSize(node->left);
-        
-        if (k == leftSize) return node;
-        if (k < leftSize) return findKthNode(node->left, k);
-        return findKthNode(node->right, k - leftSize - 1);
-    }
+// 进程的峰值常驻内存（字节），无法获取时返回 0
+size_t peakResidentBytes() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);          // macOS 以字节为单位
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;   // Linux 以 KB 为单位
+#endif
+#endif
+}
 
-    // 修改遍历方法，收集词频信息
-    void traverse(Node* node, vector<pair<string, int>>& freq) {
-        if (!node) return;
-        if (node->left) traverse(node->left, freq);
-        freq.push_back({node->key, node->count});
-        if (node->right) traverse(node->right, freq);
+/**
+ * 流式模式：边读边分词边计数，只遍历输入一次 - 时间复杂度: O(n log d)
+ * 不保存单词序列，常驻内存只有词表（树节点和单词内存区）加一个固定大小的读缓冲区，
+ * 与输入大小无关，可以直接用管道输入 GB 级的日志。
+ * inputPath 为 "-" 时读标准输入；词频结果写到标准输出，进度写到标准错误
+ */
+int runStream(const string& inputPath) {
+    bool fromStdin = inputPath == "-";
+    FILE* in = fromStdin ? stdin : fopen(inputPath.c_str(), "rb");
+    if (!in) {
+        cerr << "Error: 无法打开文件 " << inputPath << endl;
+        return 1;
     }
-
-    // 性能指标获取
-    int getOperations() const { return operationCount; }
-    Node* getRoot() { return root; }
-
-    // 将getAverageDepth移动到public部分
-    double getAverageDepth() {
-        totalDepth = 0;
-        nodeCount = 0;
-        calculateDepth(root, 0);
-        return nodeCount > 0 ? (double)totalDepth / nodeCount : 0;
+    cerr << "流式统计开始..." << endl;
+
+    SplayTree<> tree;
+    long long totalWords = 0;
+    auto start = high_resolution_clock::now();
+    size_t bytes = tokenizer::for_each_word_in_stream(in, STREAM_BUFFER_SIZE, [&](string_view word) {
+        tree.insertWithoutSplay(word);
+        if (++totalWords % STREAM_REPORT_WORDS == 0) {
+            // 前 K 名由树增量维护，轮询只需 O(K log K)
+            auto top = tree.topK();
+            cerr << "已统计 " << totalWords << " 个单词, 当前最高频: "
+                 << top[0].first << " (" << top[0].second << ")" << endl;
+        }
+    });
+    auto end = high_resolution_clock::now();
+    bool failed = ferror(in) != 0;
+    if (!fromStdin) fclose(in);
+    if (failed) {
+        cerr << "Error: 读取输入失败" << endl;
+        return 1;
     }
-
-    void resetCounters() {
-        operationCount = 0;
-        compareCount = 0;
-        accessCount = 0;
+    if (totalWords == 0) {
+        cerr << "Error: 输入中没有单词" << endl;
+        return 1;
     }
 
-    int getCompareCount() const { return compareCount; }
-    int getAccessCount() const { return accessCount; }
-
-    // 将析构函数移到public部分
-    ~SplayTree() {
-        deleteTree(root);
-    }
-};
+    writeFrequencies(cout, totalWords, static_cast<size_t>(tree.size()), tree.topK());
 
-// 二叉树
-class BST {
-private:
-    struct BSTNode {
-        string key;
-        int count = 1;
-        BSTNode* left = nullptr;
-        BSTNode* right = nullptr;
-        
-        BSTNode(const string& k) : key(k) {}
-    };
-    
-    BSTNode* root = nullptr;
-    int totalDepth = 0;
-    int nodeCount = 0;
-    int accessCount = 0;  // 添加访问计数器
-    int compareCount = 0; // 添加比较次数计数器
-
-    void deleteTree(BSTNode* node) {
-        if (node) {
-            deleteTree(node->left);
-            deleteTree(node->right);
-            delete node;
-        }
-    }
+    double ms = duration_cast<microseconds>(end - start).count() / 1000.0;
+    const NodePool<Node>& pool = tree.getNodePool();
+    const StringArena& arena = tree.getKeyArena();
+    cout << "\n=== 流式统计 ===" << endl;
+    cout << "输入大小: " << bytes << " 字节, 耗时 " << fixed << setprecision(2) << ms << " 毫秒, "
+         << bytes / (ms / 1000.0) / 1e6 << " MB/秒" << endl;
+    cout << "读缓冲区: " << STREAM_BUFFER_SIZE << " 字节" << endl;
+    cout << "词表: 节点 " << pool.bytes_reserved() << " 字节 + 单词 " << arena.bytes_reserved() << " 字节" << endl;
+    cout << "峰值常驻内存: " << peakResidentBytes() << " 字节" << endl;
+    return 0;
+}
 
+/**
+ * 近似计数：Count-Min sketch 吸收长尾，只有估计次数达到阈值的单词才进入精确的伸展树
+ * - 已在树中的单词直接在树中精确计数，不再经过 sketch
+ * - 其余单词只在 sketch 中计数，估计值达到阈值时提升到树中，计数从估计值开始
+ * sketch 的估计从不偏低，所以真实次数达到阈值的单词一定会被提升；
+ * 树中的计数只会高估，高估量不超过提升时 sketch 的误差（以 1 - δ 的概率不超过 εN）
+ */
+class ApproxCounter {
 public:
-    void insert(const string& key) {
-        root = insertRec(root, key);
-    }
-    
-    double getAverageDepth() {
-        totalDepth = 0;
-        nodeCount = 0;
-        calculateDepth(root, 0);
-        return nodeCount > 0 ? (double)totalDepth / nodeCount : 0;
-    }
-    
-    void traverse(BSTNode* node, vector<pair<string, int>>& freq) {
-        if (!node) return;
-        traverse(node->left, freq);
-        freq.push_back({node->key, node->count});
-        traverse(node->right, freq);
-    }
-    
-    vector<pair<string, int>> getFrequencies() {
-        vector<pair<string, int>> freq;
-        traverse(root, freq);
-        return freq;
-    }
-
-    void resetCounters() {
-        accessCount = 0;
-        compareCount = 0;
-    }
-    
-    int getAccessCount() const { return accessCount; }
-    int getCompareCount() const { return compareCount; }
-
-    BSTNode* search(const string& key) {
-        accessCount++;
-        BSTNode* current = root;
-        while (current) {
-            compareCount++;
-            if (key < current->key)
-                current = current->left;
-            else if (key > current->key)
-                current = current->right;
-            else
-                return current;
+    ApproxCounter(double epsilon, double delta, int threshold)
+        : sketch(epsilon, delta), threshold(max(1, threshold)) {}
+
+    void add(string_view word) {
+        if (tree.incrementIfPresent(word)) return;
+        uint32_t estimate = sketch.add(word);
+        if (estimate >= static_cast<uint32_t>(threshold)) {
+            tree.insertWithoutSplay(word, static_cast<long long>(estimate));
         }
-        return nullptr;
     }
 
-    // 将析构函数移到public部分
-    ~BST() {
-        deleteTree(root);
-    }
+    SplayTree<>& getTree() { return tree; }
+    const CountMinSketch<string_view>& getSketch() const { return sketch; }
 
 private:
-    BSTNode* insertRec(BSTNode* node, const string& key) {
-        accessCount++;
-        if (!node) return new BSTNode(key);
-        
-        compareCount++;
-        if (key < node->key)
-            node->left = insertRec(node->left, key);
-        else if (key > node->key)
-            node->right = insertRec(node->right, key);
-        else
-            node->count++;
-            
-        return node;
-    }
-    
-    void calculateDepth(BSTNode* node, int depth) {
-        if (!node) return;
-        totalDepth += depth;
-        nodeCount++;
-        calculateDepth(node->left, depth + 1);
-        calculateDepth(node->right, depth + 1);
-    }
+    CountMinSketch<string_view> sketch;
+    SplayTree<> tree;
+    int threshold;
 };
 
-// 文本处理
-vector<string> processFile(const string& filename) {
-    vector<string> words;
-    words.reserve(100000);  // 预分配空间
-    
-    ifstream file(filename, ios::in | ios::binary);
-    if (!file) return words;
-
-    char buffer[BUFFER_SIZE];
-    string word;
-    word.reserve(50);  // 预分配单词空间
-
-    while (file.read(buffer, BUFFER_SIZE) || file.gcount()) {
-        int count = file.gcount();
-        
-        for (int i = 0; i < count; i++) {
-            char c = buffer[i];
-            if (isalpha(c)) {
-                word += tolower(c);
-            } else if (!word.empty()) {
-                words.push_back(word);
-                word.clear();
-            }
-        }
+/**
+ * 近似模式：同一份输入分别做精确统计和近似统计，报告节省的内存以及近似计数相对精确计数的误差
+ * epsilon、delta 为 sketch 的误差参数，threshold 为提升到精确树的估计次数阈值；
+ * 阈值应明显大于 εN，否则长尾单词会因为 sketch 的高估被成批提升
+ */
+int runApprox(const string& inputPath, double epsilon, double delta, int threshold) {
+    MappedFile input(inputPath);
+    auto words = processFile(input);
+    if (words.empty()) {
+        cout << "Error: 无法读取文件或文件为空" << endl;
+        return 1;
     }
-
-    if (!word.empty()) {
-        words.push_back(word);
+    cout << "近似统计开始..." << endl;
+
+    SplayTree<> exact;
+    auto start = high_resolution_clock::now();
+    for (string_view word : words) exact.insertWithoutSplay(word);
+    auto end = high_resolution_clock::now();
+    double exactMs = duration_cast<microseconds>(end - start).count() / 1000.0;
+
+    ApproxCounter approx(epsilon, delta, threshold);
+    start = high_resolution_clock::now();
+    for (string_view word : words) approx.add(word);
+    end = high_resolution_clock::now();
+    double approxMs = duration_cast<microseconds>(end - start).count() / 1000.0;
+    SplayTree<>& promoted = approx.getTree();
+    const CountMinSketch<string_view>& sketch = approx.getSketch();
+
+    // 两棵树的中序遍历都按单词升序，归并比较每个单词的计数
+    vector<pair<string, long long>> exactFreq, approxFreq;
+    exact.traverse(exact.getRoot(), exactFreq);
+    promoted.traverse(promoted.getRoot(), approxFreq);
+    size_t missed = 0, withinBound = 0, exactMatches = 0;
+    long long sumError = 0, maxError = 0;
+    double bound = sketch.error_bound();
+    size_t j = 0;
+    for (const auto& [word, count] : exactFreq) {
+        if (j < approxFreq.size() && approxFreq[j].first == word) {
+            long long error = approxFreq[j].second - count;
+            sumError += error;
+            maxError = max(maxError, error);
+            withinBound += error <= bound;
+            exactMatches += error == 0;
+            j++;
+        } else if (count >= threshold) {
+            missed++;
+        }
     }
 
-    return words;
+    auto exactTop = exact.topK(), approxTop = promoted.topK();
+    size_t recalled = 0;
+    for (const auto& e : exactTop) {
+        for (const auto& a : approxTop) recalled += a.first == e.first;
+    }
+
+    size_t exactBytes = exact.getNodePool().bytes_in_use() + exact.getKeyArena().bytes_in_use();
+    size_t treeBytes = promoted.getNodePool().bytes_in_use() + promoted.getKeyArena().bytes_in_use();
+    size_t approxBytes = treeBytes + sketch.bytes();
+
+    ofstream outFile("../data/result.txt");
+    writeFrequencies(outFile, static_cast<long long>(words.size()), approxFreq.size(), approxTop);
+
+    outFile << "\n=== 近似统计（Count-Min sketch + 精确伸展树） ===" << endl;
+    outFile << "参数: ε = " << defaultfloat << epsilon << ", δ = " << delta << ", 提升阈值 " << threshold
+            << ", sketch " << sketch.width() << " × " << sketch.depth() << endl;
+    outFile << "(上面的不同单词数为提升到精确树中的单词数)" << endl;
+    outFile << "耗时: 精确 " << fixed << setprecision(2) << exactMs << " 毫秒, 近似 " << approxMs << " 毫秒" << endl;
+    outFile << "内存: 精确 " << exactBytes << " 字节 (" << exactFreq.size() << " 个节点), 近似 "
+            << approxBytes << " 字节 (树 " << treeBytes << " 字节 " << approxFreq.size()
+            << " 个节点 + sketch " << sketch.bytes() << " 字节), 节省 "
+            << (1.0 - double(approxBytes) / exactBytes) * 100 << "%" << endl;
+    outFile << "sketch 中计数的总次数 N: " << sketch.total() << ", 误差上界 εN: " << bound << endl;
+    outFile << "提升的单词: 平均高估 " << (approxFreq.empty() ? 0.0 : double(sumError) / approxFreq.size())
+            << ", 最大高估 " << maxError << ", 计数完全准确 " << exactMatches << " 个, 不超过上界 "
+            << withinBound << " / " << approxFreq.size() << endl;
+    outFile << "漏掉的高频词（真实次数不低于阈值却未提升）: " << missed << endl;
+    outFile << "前 " << exactTop.size() << " 名召回: " << recalled << " / " << exactTop.size() << endl;
+
+    cout << "\n测试完成！详细结果已保存到 ../data/result.txt" << endl;
+    return missed == 0 ? 0 : 1;
 }
 
-// 随机单词生成函数
-string generateRandomWord(int len) {
-    static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
-    string word;
-    for (int i = 0; i < len; ++i) {
-        word += charset[rand() % 26];
+/**
+ * 用法: word_frequency [--threads N | --stream | --approx [选项]] [输入文件]
+ *   不带选项时运行完整的串行对比测试（默认输入 ../data/test.txt）
+ *   带 --threads N 时运行并行分块统计，报告 1..N 线程的耗时与加速比
+ *   带 --stream 时流式统计，输入文件为 - 表示标准输入，例如 cat *.log | word_frequency --stream -
+ *   带 --approx 时对比近似统计与精确统计，可用 --epsilon、--delta、--threshold 调整误差参数和提升阈值
+ *   串行测试可加 --histogram FILE，把各结构单次操作的延迟直方图以 CSV 写入 FILE，便于作图
+ */
+int main(int argc, char* argv[]) {
+    string inputPath = "../data/test.txt";
+    unsigned threads = 0;
+    bool stream = false;
+    bool approx = false;
+    double epsilon = 1e-5, delta = 0.01;
+    int threshold = 20;
+    string histogramPath;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(stoul(argv[++i]));
+        } else if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--approx") {
+            approx = true;
+        } else if (arg == "--epsilon" && i + 1 < argc) {
+            epsilon = stod(argv[++i]);
+        } else if (arg == "--delta" && i + 1 < argc) {
+            delta = stod(argv[++i]);
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            threshold = stoi(argv[++i]);
+        } else if (arg == "--histogram" && i + 1 < argc) {
+            histogramPath = argv[++i];
+        } else {
+            inputPath = arg;
+        }
     }
-    return word;
-}
 
-int main() {
     try {
-        SplayTree splayTree;
+        if (stream) return runStream(inputPath);
+        if (approx) return runApprox(inputPath, epsilon, delta, threshold);
+        if (threads > 0) return runParallel(inputPath, threads);
+
+        SplayTree<PeriodicSplay<100>, CountingStats> splayTree;// 主树统计旋转、比较和伸展路径
         BST bst;
         
         // 读取测试文件
-        auto words = processFile("../data/test.txt");
+        // 按阶段读取硬件计数器，每个阶段返回自己的操作数，结果折算为每次操作的耗时和事件数
+        struct PhaseResult {
+            string name;
+            size_t ops;
+            double ns;
+            PerfCounters::Sample sample;
+        };
+        PerfCounters counters;
+        vector<PhaseResult> phases;
+        auto phase = [&](const char* name, auto&& body) {
+            auto start = high_resolution_clock::now();
+            counters.start();
+            size_t ops = body();
+            PerfCounters::Sample sample = counters.stop();
+            auto end = high_resolution_clock::now();
+            phases.push_back({name, ops, double(duration_cast<nanoseconds>(end - start).count()), sample});
+        };
+
+        auto loadStart = high_resolution_clock::now();
+        MappedFile input(inputPath);
+        vector<string_view> words;
+        phase("分词", [&] { words = processFile(input); return words.size(); });
+        auto loadEnd = high_resolution_clock::now();
+        double loadMicros = duration_cast<nanoseconds>(loadEnd - loadStart).count() / 1000.0;
         if (words.empty()) {
             cout << "Error: 无法读取文件或文件为空" << endl;
             return 1;
@@ -514,37 +482,68 @@ int main() {
         cout << "总单词数: " << words.size() << endl;
 
         // 先构建主树
-        splayTree.batchInsert(words);
+        phase("构建", [&] { splayTree.batchInsert(words); return words.size(); });
         for (const auto& word : words) {
             bst.insert(word);
         }
 
         // 收集词频统计
-        vector<pair<string, int>> frequencies;
+        vector<pair<string, long long>> frequencies;
         frequencies.reserve(words.size()); // 预分配空间
         
-        if (splayTree.getRoot()) {
-            splayTree.traverse(splayTree.getRoot(), frequencies);
-        }
+        phase("遍历", [&] {
+            if (splayTree.getRoot()) splayTree.traverse(splayTree.getRoot(), frequencies);
+            return frequencies.size();
+        });
         
         if (frequencies.empty()) {
             cout << "Error: 未能生成词频统计" << endl;
             return 1;
         }
 
-        sort(frequencies.begin(), frequencies.end(),
-             [](const pair<string,int>& a, const pair<string,int>& b) { 
-                 return a.second > b.second; 
-             });
+        // 前 K 名由树在插入时增量维护；与遍历后整体排序的做法对比耗时，并核对两者的计数
+        auto topStart = high_resolution_clock::now();
+        auto top = splayTree.topK();
+        auto topEnd = high_resolution_clock::now();
+        auto sortStart = high_resolution_clock::now();
+        vector<pair<string, long long>> sorted;
+        splayTree.traverse(splayTree.getRoot(), sorted);
+        phase("排序", [&] {
+            sort(sorted.begin(), sorted.end(),
+                 [](const pair<string, long long>& a, const pair<string, long long>& b) { 
+                     return a.second > b.second; 
+                 });
+            return sorted.size();
+        });
+        auto sortEnd = high_resolution_clock::now();
+        double topMicros = duration_cast<nanoseconds>(topEnd - topStart).count() / 1000.0;
+        double sortMicros = duration_cast<nanoseconds>(sortEnd - sortStart).count() / 1000.0;
+        bool topConsistent = true;
+        for (size_t i = 0; i < top.size(); i++) topConsistent &= top[i].second == sorted[i].second;
+
+        // 热点访问：另建一棵树反复查询最高频单词，不改变主树的旋转次数
+        bool hotConsistent = true;
+        {
+            SplayTree<> hotTree;
+            hotTree.buildFromSorted(frequencies.begin(), frequencies.end());
+            string_view hottest = top[0].first;
+            const size_t HOT_ACCESSES = 1000000;
+            long long hotSum = 0;
+            phase("热点访问", [&] {
+                for (size_t i = 0; i < HOT_ACCESSES; i++) hotSum += hotTree.getCount(hottest);
+                return HOT_ACCESSES;
+            });
+            hotConsistent = hotSum == (long long)HOT_ACCESSES * top[0].second;
+        }
 
         // 性能测试部分
         vector<long long> splayTimes, bstTimes;
         vector<long long> splayHotTimes, bstHotTimes;
         const int TEST_ITERATIONS = 5;
 
-        // 多次测试插入性能
+        // 多次测试插入性能；与 BST 对比的两项都用每次完全伸展的树，热点词每次都被提到根
         for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
-            SplayTree testSplay;
+            SplayTree<FullSplay> testSplay;
             BST testBst;
 
             // Splay Tree测试
@@ -563,11 +562,11 @@ int main() {
         }
 
         // 热点词性能测试
-        string hotWord = frequencies[0].first;
+        string hotWord = top[0].first;
         const int HOT_TEST_COUNT = 10000;
         
         for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
-            SplayTree testSplay;
+            SplayTree<FullSplay> testSplay;
             BST testBst;
             
             // 先构建树
@@ -597,8 +596,144 @@ int main() {
             bstHotTimes.push_back(duration_cast<nanoseconds>(end - start).count());
         }
 
+        // 伸展引擎对比：逐词插入，每次访问都完全伸展
+        vector<long long> bottomUpTimes, topDownTimes;
+        size_t bottomUpDistinct = 0, topDownDistinct = 0;
+        for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+            SplayTree<FullSplay> bottomUp;
+            TopDownSplayTree topDown;
+
+            auto start = high_resolution_clock::now();
+            for (const auto& word : words) {
+                bottomUp.insert(word);
+            }
+            auto end = high_resolution_clock::now();
+            bottomUpTimes.push_back(duration_cast<nanoseconds>(end - start).count());
+
+            start = high_resolution_clock::now();
+            for (const auto& word : words) {
+                topDown.insert(word);
+            }
+            end = high_resolution_clock::now();
+            topDownTimes.push_back(duration_cast<nanoseconds>(end - start).count());
+
+            if (iter == 0) {
+                vector<pair<string, long long>> check;
+                bottomUp.traverse(bottomUp.getRoot(), check);
+                bottomUpDistinct = check.size();
+                check.clear();
+                topDown.traverse(topDown.getRoot(), check);
+                topDownDistinct = check.size();
+            }
+        }
+
+        // 排序聚合后批量构建，与逐词插入对比
+        vector<long long> bulkTimes;
+        size_t bulkDistinct = 0;
+        for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+            SplayTree<> bulkTree;
+
+            auto start = high_resolution_clock::now();
+            auto aggregated = aggregateSorted(words);
+            bulkTree.buildFromSorted(aggregated.begin(), aggregated.end());
+            auto end = high_resolution_clock::now();
+            bulkTimes.push_back(duration_cast<nanoseconds>(end - start).count());
+            bulkDistinct = bulkTree.size();
+        }
+
+        // 热点旁路表：按 Zipf 分布访问语料中的不同单词，比较不同偏斜程度和表大小下的耗时和命中率
+        struct LookasideResult {
+            double skew;
+            size_t slots;
+            double nsPerOp;
+            double hitRate;
+        };
+        vector<LookasideResult> lookasideResults;
+        const size_t ZIPF_PROBES = 1000000;
+        {
+            vector<string_view> ranked;
+            ranked.reserve(frequencies.size());
+            for (const auto& f : frequencies) ranked.push_back(f.first);
+            mt19937 gen(42);
+            shuffle(ranked.begin(), ranked.end(), gen);// 热度与字典序无关
+            for (double skew : {1.0, 1.2}) {
+                ZipfGenerator zipf(ranked.size(), skew);
+                vector<string_view> probes(ZIPF_PROBES);
+                for (auto& p : probes) p = ranked[zipf(gen)];
+
+                for (size_t slots : {size_t(0), size_t(64), size_t(1024), size_t(16384)}) {
+                    SplayTree<FullSplay> tree;// 未命中旁路表时每次伸展到根
+                    tree.buildFromSorted(frequencies.begin(), frequencies.end());
+                    tree.setLookasideSize(slots);
+                    auto start = high_resolution_clock::now();
+                    for (string_view p : probes) tree.insert(p);
+                    auto end = high_resolution_clock::now();
+                    double ns = double(duration_cast<nanoseconds>(end - start).count());
+                    size_t lookups = tree.getLookasideHits() + tree.getLookasideMisses();
+                    lookasideResults.push_back({skew, tree.getLookasideSize(), ns / probes.size(),
+                                                lookups ? double(tree.getLookasideHits()) / lookups : 0.0});
+                }
+            }
+        }
+
+        // 单次操作延迟：逐次计时记入直方图，均值会掩盖少数沿深链伸展的慢操作，这里看分位数
+        // 用 steady_clock 保证单调，两次取时之间的开销单独测出，包含在每个记录值中
+        struct LatencyResult {
+            string structure;
+            string operation;
+            LatencyHistogram histogram;
+        };
+        vector<LatencyResult> latencyResults;
+        LatencyHistogram timerOverhead;
+        vector<long long> lookupSums;
+        const size_t LATENCY_PROBES = 200000;
+        {
+            for (size_t i = 0; i < LATENCY_PROBES; i++) {
+                auto start = steady_clock::now();
+                auto end = steady_clock::now();
+                timerOverhead.record(duration_cast<nanoseconds>(end - start).count());
+            }
+
+            vector<string_view> ranked;
+            ranked.reserve(frequencies.size());
+            for (const auto& f : frequencies) ranked.push_back(f.first);
+            mt19937 gen(7);
+            shuffle(ranked.begin(), ranked.end(), gen);
+            ZipfGenerator zipf(ranked.size(), 1.0);
+            vector<string_view> probes(LATENCY_PROBES);
+            for (auto& p : probes) p = ranked[zipf(gen)];
+
+            // 插入：按语料顺序逐词插入；查询：插入完成后按 Zipf 分布查询计数
+            auto measure = [&](const char* name, auto& tree) {
+                LatencyResult inserts{name, "插入", LatencyHistogram()};
+                for (const auto& word : words) {
+                    auto start = steady_clock::now();
+                    tree.insert(word);
+                    auto end = steady_clock::now();
+                    inserts.histogram.record(duration_cast<nanoseconds>(end - start).count());
+                }
+                LatencyResult lookups{name, "查询", LatencyHistogram()};
+                long long sum = 0;
+                for (string_view p : probes) {
+                    auto start = steady_clock::now();
+                    sum += tree.getCount(p);
+                    auto end = steady_clock::now();
+                    lookups.histogram.record(duration_cast<nanoseconds>(end - start).count());
+                }
+                lookupSums.push_back(sum);
+                latencyResults.push_back(std::move(inserts));
+                latencyResults.push_back(std::move(lookups));
+            };
+            { SplayTree<> tree; measure("伸展树(每100次伸展)", tree); }
+            { SplayTree<FullSplay> tree; measure("伸展树(每次完全伸展)", tree); }
+            { TopDownSplayTree tree; measure("自顶向下伸展树", tree); }
+            { BST tree; measure("BST", tree); }
+        }
+        bool lookupConsistent = all_of(lookupSums.begin(), lookupSums.end(),
+                                       [&](long long s) { return s == lookupSums.front(); });
+
         // 计算统计数据
-        auto calcStats = [](const vector<long long>& times) -> pair<double, double> {
+        auto calcStats =[](const vector<long long>& times) -> pair<double, double> {
             if (times.empty()) return {0.0, 0.0};
             double avg = accumulate(times.begin(), times.end(), 0.0) / times.size();
             double variance = 0;
@@ -614,36 +749,20 @@ int main() {
         auto bstStats = calcStats(bstTimes);
         auto splayHotStats = calcStats(splayHotTimes);
         auto bstHotStats = calcStats(bstHotTimes);
+        auto bottomUpStats = calcStats(bottomUpTimes);
+        auto topDownStats = calcStats(topDownTimes);
+        auto bulkStats = calcStats(bulkTimes);
 
         // 输出结果到文件
         ofstream outFile("../data/result.txt");
         
         // 1. 输出词频统计
-        outFile << "=== 词频统计结果 ===" << endl;
-        outFile << "总单词数：" << words.size() << endl;
-        outFile << "不同单词数：" << frequencies.size() << endl << endl;
-        
-        outFile << "词频排序（前20个）：" << endl;
-        outFile << "单词\t\t出现次数\t占比" << endl;
-        outFile << "----------------------------------------" << endl;
-        
-        int totalWords = 0;
-        for (const auto& freq : frequencies) {
-            totalWords += freq.second;
-        }
-        
-        for (int i = 0; i < min(20, (int)frequencies.size()); i++) {
-            const auto& freq = frequencies[i];
-            double percentage = (freq.second * 100.0) / totalWords;
-            outFile << freq.first << "\t\t" 
-                    << freq.second << "\t\t"
-                    << fixed << setprecision(2) << percentage << "%" << endl;
-        }
+        writeFrequencies(outFile, splayTree.getTotalCount(), frequencies.size(), top);
 
         // 2. 输出性能指标
         outFile << "\n=== 性能测试结果 ===" << endl;
         outFile << "1. 插入性能：" << endl;
-        outFile << "   Splay Tree: " << fixed << setprecision(2) 
+        outFile << "   Splay Tree(每次完全伸展): " << fixed << setprecision(2) 
                 << splayStats.first << " ± " << splayStats.second << " 微秒/操作" << endl;
         outFile << "   BST: " << bstStats.first << " ± " << bstStats.second << " 微秒/操作" << endl;
         outFile << "   性能比: " << (bstStats.first / splayStats.first) << endl;
@@ -651,7 +770,7 @@ int main() {
         outFile << "\n2. 热点词访问性能：" << endl;
         outFile << "   测试词: " << hotWord << endl;
         outFile << "   测试次数: " << HOT_TEST_COUNT << endl;
-        outFile << "   Splay Tree: " << fixed << setprecision(3) 
+        outFile << "   Splay Tree(每次完全伸展): " << fixed << setprecision(3) 
                 << splayHotStats.first / HOT_TEST_COUNT << " ± " 
                 << splayHotStats.second / HOT_TEST_COUNT << " 微秒/操作" << endl;
         outFile << "   BST: " << bstHotStats.first / HOT_TEST_COUNT << " ± " 
@@ -661,12 +780,20 @@ int main() {
 
         outFile << "\n3. 操作计数统计：" << endl;
         outFile << "   总旋转次数: " << splayTree.getOperations() << endl;
+        const CountingStats& stats = splayTree.getStats();
+        outFile << "   伸展步骤: zig " << stats.zigs << ", zig-zig " << stats.zig_zigs
+                << ", zig-zag " << stats.zig_zags << endl;
+        outFile << "   访问 " << stats.accesses << " 次, 键比较 " << stats.comparisons << " 次, 新建节点 "
+                << stats.allocations << " 个" << endl;
+        outFile << "   伸展 " << stats.splays << " 次, 路径长度 平均 " << fixed << setprecision(2)
+                << stats.average_path() << ", p50 " << stats.path_percentile(50) << ", p99 "
+                << stats.path_percentile(99) << ", 最长 " << stats.longest_path << endl;
         outFile << "   平均深度: " << splayTree.getAverageDepth() << endl;
 
         // 输出性能对比结果
         outFile << "\n=== 树结构性能对比 ===" << endl;
         outFile << "1. 插入性能对比：" << endl;
-        outFile << "   Splay Tree总时间: " << splayStats.first << " 微秒" << endl;
+        outFile << "   Splay Tree(每次完全伸展)总时间: " << splayStats.first << " 微秒" << endl;
         outFile << "   BST总时间: " << bstStats.first << " 微秒" << endl;
         outFile << "   性能提升: " << fixed << setprecision(2) 
                 << ((double)bstStats.first / splayStats.first - 1.0) * 100 
@@ -682,7 +809,7 @@ int main() {
         outFile << "\n3. 热点词访问性能对比：" << endl;
         outFile << "   测试词: " << hotWord << endl;
         outFile << "   测试次数: " << HOT_TEST_COUNT << endl;
-        outFile << "   Splay Tree平均访问时间: " 
+        outFile << "   Splay Tree(每次完全伸展)平均访问时间: " 
                 << splayHotStats.first / HOT_TEST_COUNT << " 微秒" << endl;
         outFile << "   BST平均访问时间: " 
                 << bstHotStats.first / HOT_TEST_COUNT << " 微秒" << endl;
@@ -690,6 +817,144 @@ int main() {
                 << ((double)bstHotStats.first / splayHotStats.first - 1.0) * 100 
                 << "%" << endl;
 
+        // 4. 伸展引擎对比
+        auto wordsPerSec = [&](double micros) { return words.size() / (micros / 1e6); };
+        outFile << "\n4. 伸展引擎对比（逐词插入，每次完全伸展）：" << endl;
+        outFile << "   自底向上 (parent指针): " << fixed << setprecision(2)
+                << bottomUpStats.first << " ± " << bottomUpStats.second << " 微秒, "
+                << setprecision(0) << wordsPerSec(bottomUpStats.first) << " 词/秒, "
+                << "不同单词数 " << bottomUpDistinct << endl;
+        outFile << "   自顶向下 (无parent指针): " << fixed << setprecision(2)
+                << topDownStats.first << " ± " << topDownStats.second << " 微秒, "
+                << setprecision(0) << wordsPerSec(topDownStats.first) << " 词/秒, "
+                << "不同单词数 " << topDownDistinct << endl;
+        outFile << "   节点大小: " << sizeof(Node) << " 字节 -> " << sizeof(TopDownNode) << " 字节" << endl;
+        outFile << "   吞吐提升: " << fixed << setprecision(2)
+                << (bottomUpStats.first / topDownStats.first - 1.0) * 100 << "%" << endl;
+
+        // 5. 伸展策略对比：同一份语料批量插入，比较耗时、旋转次数和平均深度
+        outFile << "\n5. 伸展策略对比（批量插入）：" << endl;
+        auto reportPolicy = [&](const char* name, auto tree) {
+            auto start = high_resolution_clock::now();
+            tree.batchInsert(words);
+            auto end = high_resolution_clock::now();
+            outFile << "   " << name << ": " << fixed << setprecision(2)
+                    << duration_cast<nanoseconds>(end - start).count() / 1000.0 << " 微秒, "
+                    << "旋转次数 " << tree.getOperations() << ", "
+                    << "平均深度 " << tree.getAverageDepth() << endl;
+        };
+        reportPolicy("每100次伸展", SplayTree<PeriodicSplay<100>, CountingStats>());
+        reportPolicy("每次完全伸展", SplayTree<FullSplay, CountingStats>());
+        reportPolicy("每次半伸展", SplayTree<SemiSplay, CountingStats>());
+        reportPolicy("深度超过32时伸展", SplayTree<DepthThresholdSplay<32>, CountingStats>());
+        reportPolicy("以10%概率伸展", SplayTree<RandomizedSplay<100>, CountingStats>());
+
+        // 6. 批量构建
+        outFile << "\n6. 排序聚合 + 批量构建：" << endl;
+        outFile << "   逐词插入(batchInsert): " << fixed << setprecision(2)
+                << splayStats.first << " 微秒" << endl;
+        outFile << "   排序聚合+批量构建: " << bulkStats.first << " ± " << bulkStats.second
+                << " 微秒, 不同单词数 " << bulkDistinct << endl;
+        outFile << "   性能提升: " << (splayStats.first / bulkStats.first - 1.0) * 100 << "%" << endl;
+
+        // 7. 输入处理
+        outFile << "\n7. 输入处理（内存映射 + 就地分词）：" << endl;
+        outFile << "   输入大小: " << input.size() << " 字节, 分词实现: "
+                << tokenizer::level_name(tokenizer::best_level()) << endl;
+        outFile << "   映射+分词: " << fixed << setprecision(2) << loadMicros << " 微秒, "
+                << input.size() / loadMicros << " MB/秒" << endl;
+        outFile << "   单词以 string_view 指向映射区, 额外内存 "
+                << words.size() * sizeof(string_view) << " 字节, 只有 "
+                << frequencies.size() << " 个不同单词复制到树节点中" << endl;
+
+        // 8. 单词存储：与每个节点持有 std::string 的布局对比
+        const NodePool<Node>& pool = splayTree.getNodePool();
+        const StringArena& arena = splayTree.getKeyArena();
+        size_t inlineCapacity = string().capacity();// 短字符串优化能容纳的长度，超过时 std::string 单独申请堆内存
+        size_t heapStrings = 0, heapBytes = 0;
+        for (const auto& f : frequencies) {
+            if (f.first.size() > inlineCapacity) {
+                heapStrings++;
+                heapBytes += f.first.size() + 1;
+            }
+        }
+        size_t stringNodeSize = sizeof(Node) - sizeof(string_view) + sizeof(string);
+        outFile << "\n8. 单词存储（字符串内存区）：" << endl;
+        outFile << "   节点大小: " << sizeof(Node) << " 字节（std::string 键为 " << stringNodeSize << " 字节）" << endl;
+        outFile << "   节点 " << pool.bytes_in_use() << " 字节 + 单词 " << arena.bytes_in_use()
+                << " 字节, 共 " << pool.bytes_in_use() + arena.bytes_in_use() << " 字节, 单词内存区 "
+                << arena.block_count() << " 块" << endl;
+        outFile << "   std::string 键: 节点 " << pool.current_nodes() * stringNodeSize << " 字节 + 堆上单词 "
+                << heapBytes << " 字节, 共 " << pool.current_nodes() * stringNodeSize + heapBytes
+                << " 字节, 长于 " << inlineCapacity << " 的 " << heapStrings << " 个单词各需一次堆分配" << endl;
+
+        // 9. 前 K 名
+        outFile << "\n9. 前 " << top.size() << " 名（插入时增量维护）：" << endl;
+        outFile << "   topK(): " << fixed << setprecision(2) << topMicros << " 微秒" << endl;
+        outFile << "   遍历 " << sorted.size() << " 个节点后整体排序: " << sortMicros << " 微秒" << endl;
+        outFile << "   两者计数一致: " << (topConsistent ? "是" : "否") << endl;
+
+        // 10. 热点旁路表
+        outFile << "\n10. 热点旁路表（Zipf 分布访问 " << ZIPF_PROBES << " 次, 逐次插入）：" << endl;
+        outFile << "   偏斜 s\t槽位数\t纳秒/操作\t命中率" << endl;
+        for (const auto& r : lookasideResults) {
+            outFile << "   " << fixed << setprecision(1) << r.skew << "\t" << r.slots << "\t"
+                    << r.nsPerOp << "\t\t" << setprecision(2) << r.hitRate * 100 << "%" << endl;
+        }
+
+        // 11. 单次操作延迟分布
+        outFile << "\n11. 单次操作延迟（纳秒, 对数分桶直方图, 相对误差不超过 "
+                << fixed << setprecision(1) << 100.0 / LatencyHistogram::SUB_BUCKETS << "%）：" << endl;
+        outFile << "   计时开销: p50 " << timerOverhead.percentile(50) << " 纳秒, p99 "
+                << timerOverhead.percentile(99) << " 纳秒（已包含在下列数值中）" << endl;
+        outFile << "   结构\t\t\t操作\t次数\tp50\tp90\tp99\tp99.9\t最大" << endl;
+        for (const auto& r : latencyResults) {
+            const LatencyHistogram& h = r.histogram;
+            outFile << "   " << r.structure << "\t" << r.operation << "\t" << h.count() << "\t"
+                    << h.percentile(50) << "\t" << h.percentile(90) << "\t" << h.percentile(99) << "\t"
+                    << h.percentile(99.9) << "\t" << h.max() << endl;
+        }
+        outFile << "   各结构查询结果一致: " << (lookupConsistent ? "是" : "否") << endl;
+        if (!histogramPath.empty()) {
+            ofstream histogramFile(histogramPath);
+            histogramFile << "structure,operation,low_ns,high_ns,count,cumulative" << endl;
+            for (const auto& r : latencyResults) r.histogram.write(histogramFile, r.structure + "," + r.operation);
+            outFile << "   完整直方图已写入 " << histogramPath << endl;
+        }
+
+        // 12. 分阶段硬件计数器
+        outFile << "\n12. 分阶段耗时与硬件计数器（每次操作）：" << endl;
+        if (!counters.available()) {
+            outFile << "   硬件计数器不可用（" << counters.error() << "），只报告耗时" << endl;
+        }
+        outFile << "   阶段\t操作数\t纳秒";
+        if (counters.available()) outFile << "\t周期\t指令\tIPC\tL1d缺失\tLLC缺失\t分支误预测";
+        outFile << endl;
+        for (const auto& p : phases) {
+            auto perOp = [&](PerfCounters::Event e) -> string {
+                if (!p.sample.valid[e] || p.ops == 0) return "-";
+                ostringstream text;
+                text << fixed << setprecision(2) << double(p.sample.value[e]) / p.ops;
+                return text.str();
+            };
+            outFile << "   " << p.name << "\t" << p.ops << "\t" << fixed << setprecision(2)
+                    << (p.ops ? p.ns / p.ops : 0.0);
+            if (counters.available()) {
+                const auto& v = p.sample.value;
+                const auto& valid = p.sample.valid;
+                outFile << "\t" << perOp(PerfCounters::CYCLES) << "\t" << perOp(PerfCounters::INSTRUCTIONS) << "\t";
+                if (valid[PerfCounters::CYCLES] && valid[PerfCounters::INSTRUCTIONS] && v[PerfCounters::CYCLES] > 0) {
+                    outFile << double(v[PerfCounters::INSTRUCTIONS]) / v[PerfCounters::CYCLES];
+                } else {
+                    outFile << "-";
+                }
+                outFile << "\t" << perOp(PerfCounters::L1D_MISSES) << "\t" << perOp(PerfCounters::LLC_MISSES)
+                        << "\t" << perOp(PerfCounters::BRANCH_MISSES);
+            }
+            outFile << endl;
+        }
+        outFile << "   热点访问计数正确: " << (hotConsistent ? "是" : "否") << endl;
+
         cout << "\n测试完成！详细结果已保存到 ../data/result.txt" << endl;
         cout << "文件包含：词频统计、性能对比数据、树的特性分析" << endl;
 
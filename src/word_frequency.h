@@ -0,0 +1,1085 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "bulk_build.h"
+#include "key_prefix.h"
+#include "node_pool.h"
+#include "splay_policy.h"
+#include "splay_stats.h"
+#include "string_arena.h"
+
+/**
+ * 词频统计用的三种树：以单词为键、带出现次数的伸展树（自底向上）、自顶向下伸展树和普通二叉搜索树
+ *
+ * 放在 word_frequency 命名空间中，可以与通用的 SplayTree<T, Comp>（splay_tree.h）同时使用，
+ * 例如在 structure_benchmark 中一起对比。
+ */
+namespace word_frequency {
+
+/**
+ * 伸展树节点定义
+ * 包含键值、计数、子树大小、左右子节点和父节点指针
+ * 键只保存 (指针, 长度)，单词本身存放在所属树的字符串内存区中
+ */
+struct Node {
+    std::string_view key;   // 单词
+    uint64_t prefix;   // 单词前 8 个字节的大端序整数，下降时大多数比较只需比较它
+    long long count = 1;  // 出现次数，与总词数同为 64 位，超大输入中的高频词不会溢出
+    uint32_t size = 1;    // 子树大小（用于按排名查找），32 位足够容纳不同单词数，节点保持 64 字节
+    int heapIndex = -1;      // 在前 K 名小顶堆中的下标，不在堆中为 -1
+    Node* left = nullptr;    // 左子节点
+    Node* right = nullptr;   // 右子节点
+    Node* parent = nullptr;  // 父节点（用于伸展操作）
+
+    Node(std::string_view k) : key(k), prefix(key_prefix::load(k)) {}
+};
+
+/**
+ * SplayPolicy 决定插入和查询后是否伸展及伸展方式（见 splay_policy.h），
+ * 默认每100次操作才伸展一次，减少开销
+ * Stats 决定是否统计旋转、比较和伸展路径长度（见 splay_stats.h），默认由 SPLAY_TREE_STATS 选择
+ */
+template<typename SplayPolicy = PeriodicSplay<100>, typename Stats = DefaultSplayStats>
+class SplayTree {
+private:
+    Node* root = nullptr;
+    NodePool<Node> nodePool;   // 节点内存池，整棵树的节点集中在连续内存块中
+    StringArena keyArena;      // 单词内存区，每个不同单词复制一次，随树一起整体释放
+    SplayPolicy policy;
+    Stats stats;               // 性能分析用的计数，NoStats 时不产生任何代码
+
+    /**
+     * 条件伸展操作 - 优化策略
+     * 由伸展策略决定本次访问是否伸展，策略在编译期选定，不伸展时只剩一次内联判断
+     * 这样可以减少频繁旋转带来的开销，同时保持伸展树的自调整特性
+     * 
+     * @param x 需要考虑伸展的节点
+     * @param depth x 在树中的深度
+     */
+    void conditionalSplay(Node* x, size_t depth) {
+        if (policy.should_splay(depth)) {
+            if constexpr (SplayPolicy::semi) semiSplay(x);
+            else splay(x);
+        }
+    }
+
+    /**
+     * 伸展操作 - 将节点x旋转到根部位置
+     * 通过一系列旋转，使得被访问的节点成为树的根节点
+     * 时间复杂度: 平摊O(log n)
+     * 
+     * @param x 需要伸展到根部的节点
+     */
+    void splay(Node* x) {
+        if (!x) return;
+        size_t length = 0;
+
+        while (x->parent) {
+            Node* p = x->parent;
+            Node* g = p->parent;
+
+            if (!g) {
+                singleRotate(x);
+                length++;
+            } else {
+                doubleRotate(x);
+                length += 2;
+            }
+        }
+        stats.splay_path(length);
+        root = x;
+    }
+
+    /**
+     * 半伸展操作 - 将节点x向根部移动约一半路径
+     * Zig-Zig情况只旋转祖父节点，然后从父节点继续向上；其余情况与完全伸展相同
+     * 时间复杂度: 平摊O(log n)
+     * 
+     * @param x 需要伸展的节点
+     */
+    void semiSplay(Node* x) {
+        if (!x) return;
+        size_t length = 0;
+
+        while (x->parent && x->parent->parent) {
+            Node* p = x->parent;
+            Node* g = p->parent;
+            length += 2;
+
+            if (x == p->left && p == g->left) {
+                stats.zig_zig();
+                rotateRight(g);
+                x = p;
+            } else if (x == p->right && p == g->right) {
+                stats.zig_zig();
+                rotateLeft(g);
+                x = p;
+            } else {
+                doubleRotate(x);
+            }
+        }
+        if (x->parent) {
+            singleRotate(x);
+            length++;
+        }
+        stats.splay_path(length);
+    }
+
+    /**
+     * 单旋转优化 - 处理父节点是根的情况
+     * 对应Zig或Zag操作
+     * 时间复杂度: O(1)
+     * 
+     * @param x 需要旋转的节点
+     */
+    void singleRotate(Node* x) {
+        stats.zig();
+        Node* p = x->parent;
+        if (x == p->left) {
+            rotateRight(p);
+        } else {
+            rotateLeft(p);
+        }
+    }
+
+    /**
+     * 双旋转优化 - 处理父节点不是根的情况
+     * 对应Zig-Zig、Zig-Zag、Zag-Zig、Zag-Zag四种情况
+     * 时间复杂度: O(1)
+     * 
+     * @param x 需要旋转的节点
+     */
+    void doubleRotate(Node* x) {
+        Node* p = x->parent;
+        Node* g = p->parent;
+        
+        if (x == p->left && p == g->left) {
+            stats.zig_zig();
+            rotateRight(g);
+            rotateRight(p);
+        } else if (x == p->right && p == g->right) {
+            stats.zig_zig();
+            rotateLeft(g);
+            rotateLeft(p);
+        } else if (x == p->right && p == g->left) {
+            stats.zig_zag();
+            rotateLeft(p);
+            rotateRight(g);
+        } else {
+            stats.zig_zag();
+            rotateRight(p);
+            rotateLeft(g);
+        }
+    }
+
+    /**
+     * 左旋转操作 - 时间复杂度: O(1)
+     * 将节点x的右子节点y提升为其位置，x变为y的左子节点
+     * 
+     *    x          y
+     *   / \        / \
+     *  a   y  =>  x   c
+     *     / \    / \
+     *    b   c  a   b
+     * 
+     * @param x 需要左旋的节点
+     */
+    void rotateLeft(Node* x) {
+        Node* y = x->right;
+        stats.rotation();
+        
+        x->right = y->left;
+        if (y->left) y->left->parent = x;
+        
+        y->parent = x->parent;
+        if (!x->parent) root = y;
+        else if (x == x->parent->left) x->parent->left = y;
+        else x->parent->right = y;
+        
+        y->left = x;
+        x->parent = y;
+
+        y->size = x->size;
+        x->size = 1 + getSize(x->left) + getSize(x->right);
+    }
+
+    /**
+     * 右旋转操作 - 时间复杂度: O(1)
+     * 将节点x的左子节点y提升为其位置，x变为y的右子节点
+     * 
+     *    x          y
+     *   / \        / \
+     *  y   c  =>  a   x
+     * / \            / \
+     *a   b          b   c
+     * 
+     * @param x 需要右旋的节点
+     */
+    void rotateRight(Node* x) {
+        Node* y = x->left;
+        stats.rotation();
+        
+        x->left = y->right;
+        if (y->right) y->right->parent = x;
+        
+        y->parent = x->parent;
+        if (!x->parent) root = y;
+        else if (x == x->parent->right) x->parent->right = y;
+        else x->parent->left = y;
+        
+        y->right = x;
+        x->parent = y;
+
+        y->size = x->size;
+        x->size = 1 + getSize(x->left) + getSize(x->right);
+    }
+
+    // 添加计算平均深度的方法
+    uint64_t totalDepth = 0;
+    size_t nodeCount = 0;
+
+    // 借助 parent 指针做先序遍历，prev 记录上一步所在的节点以判断是从哪个方向回来的，额外空间 O(1)
+    void calculateDepth(Node* node, size_t depth) {
+        Node* stop = node ? node->parent : nullptr;
+        Node* prev = stop;
+        while (node != stop) {
+            Node* next;
+            if (prev == node->parent) {// 第一次到达
+                totalDepth += depth;
+                nodeCount++;
+                next = node->left ? node->left : node->right ? node->right : node->parent;
+            } else if (prev == node->left) {// 左子树已遍历完
+                next = node->right ? node->right : node->parent;
+            } else {
+                next = node->parent;
+            }
+            if (next == node->parent) depth--;// 最后回到 stop 时回绕，之后不再使用
+            else depth++;
+            prev = node;
+            node = next;
+        }
+    }
+
+    // 把左孩子不断右旋上来，树被压成右链后逐个释放，额外空间 O(1)
+    void deleteTree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* l = node->left;
+                node->left = l->right;
+                l->right = node;
+                node = l;
+            } else {
+                Node* next = node->right;
+                nodePool.deallocate(node);
+                node = next;
+            }
+        }
+    }
+
+    // 与节点的键三路比较：先比较缓存的前缀，前缀相同时才读取单词本身
+    static int compareKey(uint64_t prefix, std::string_view key, const Node* node) {
+        return key_prefix::compare(prefix, key, node->prefix, node->key);
+    }
+
+    // 新节点挂到node下之后，沿父指针把路径上每个祖先的子树大小加一
+    void growAncestors(Node* node) {
+        for (; node; node = node->parent) node->size++;
+    }
+
+    /**
+     * 前 K 名（heavy hitters）的增量维护
+     * topHeap 是按排名的小顶堆，堆顶是前 K 名中排名最低的节点；节点记录自己在堆中的下标，
+     * 计数变化时可以直接定位并调整，不需要遍历整棵树
+     */
+    std::vector<Node*> topHeap;
+    size_t topCapacity = 20;
+    long long totalCount = 0;  // 所有单词的出现次数之和
+
+    // 排名先比次数，次数相同时字典序小的靠前，结果与插入顺序无关
+    static bool ranksBelow(const Node* a, const Node* b) {
+        return a->count != b->count ? a->count < b->count : a->key > b->key;
+    }
+
+    void placeInHeap(Node* x, size_t i) {
+        topHeap[i] = x;
+        x->heapIndex = static_cast<int>(i);
+    }
+
+    void siftUp(size_t i) {
+        Node* x = topHeap[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!ranksBelow(x, topHeap[parent])) break;
+            placeInHeap(topHeap[parent], i);
+            i = parent;
+        }
+        placeInHeap(x, i);
+    }
+
+    void siftDown(size_t i) {
+        Node* x = topHeap[i];
+        size_t n = topHeap.size();
+        while (2 * i + 1 < n) {
+            size_t child = 2 * i + 1;
+            if (child + 1 < n && ranksBelow(topHeap[child + 1], topHeap[child])) child++;
+            if (!ranksBelow(topHeap[child], x)) break;
+            placeInHeap(topHeap[child], i);
+            i = child;
+        }
+        placeInHeap(x, i);
+    }
+
+    /**
+     * 节点 x 新建或计数加一之后更新前 K 名 - 时间复杂度: O(log K)，多数情况只比较一次堆顶
+     * 计数只增不减，每次只有 x 的排名上升，所以堆外节点的排名始终不高于堆顶：
+     * x 已在堆中时向下调整；堆未满时加入；否则只有排名超过堆顶时才替换堆顶
+     */
+    void updateTop(Node* x) {
+        if (x->heapIndex >= 0) {
+            siftDown(static_cast<size_t>(x->heapIndex));
+        } else if (topHeap.size() < topCapacity) {
+            topHeap.push_back(x);
+            siftUp(topHeap.size() - 1);
+        } else if (topCapacity > 0 && ranksBelow(topHeap[0], x)) {
+            topHeap[0]->heapIndex = -1;
+            placeInHeap(x, 0);
+            siftDown(0);
+        }
+    }
+
+    // 按现有计数重新选出前 K 名 - 时间复杂度: O(n log K)，沿 parent 指针中序遍历
+    void rebuildTop() {
+        for (Node* x : topHeap) x->heapIndex = -1;
+        topHeap.clear();
+        Node* node = root;
+        while (node && node->left) node = node->left;
+        while (node) {
+            updateTop(node);
+            if (node->right) {
+                node = node->right;
+                while (node->left) node = node->left;
+            } else {
+                Node* p = node->parent;
+                while (p && node == p->right) {
+                    node = p;
+                    p = p->parent;
+                }
+                node = p;
+            }
+        }
+    }
+
+    /**
+     * 热点旁路表（lookaside）：直接映射的小表，按单词的哈希定位槽位，槽中记录哈希和节点指针
+     * 访问时先查表，命中就直接在节点上计数，不比较字符串、不伸展，O(1)；
+     * 未命中时照常在树中查找，再把找到或新建的节点写入槽位，覆盖原来的内容。
+     * 节点只在整棵树释放时才会删除，旋转不改变节点地址，所以表项不会悬空
+     */
+    struct LookasideSlot {
+        size_t hash = 0;
+        Node* node = nullptr;
+    };
+    std::vector<LookasideSlot> lookaside;   // 为空表示不启用
+    size_t lookasideHits = 0;
+    size_t lookasideMisses = 0;
+
+    // key 对应的槽位，未启用时返回 nullptr；h 返回 key 的哈希
+    LookasideSlot* lookasideSlot(std::string_view key, size_t& h) {
+        if (lookaside.empty()) return nullptr;
+        h = std::hash<std::string_view>()(key);
+        // 乘法散列取高位，避免哈希低位分布不均
+        size_t index = static_cast<size_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> 32);
+        return &lookaside[index & (lookaside.size() - 1)];
+    }
+
+    // 槽位命中 key 时返回节点并计入命中次数，否则计入未命中次数
+    Node* lookasideHit(LookasideSlot* slot, size_t h, std::string_view key) {
+        if (!slot) return nullptr;
+        if (slot->node && slot->hash == h && slot->node->key == key) {
+            lookasideHits++;
+            return slot->node;
+        }
+        lookasideMisses++;
+        return nullptr;
+    }
+
+    static void remember(LookasideSlot* slot, size_t h, Node* node) {
+        if (slot) *slot = {h, node};
+    }
+
+public:
+    // 插入后按伸展策略伸展（FullSplay 时每次都伸展到根）；key 可以直接指向输入缓冲区，只有新单词才复制到节点中
+    // 启用旁路表时先查表，命中的热点单词只计数不伸展
+    void insert(std::string_view key) {
+        stats.access();
+        size_t h = 0;
+        LookasideSlot* slot = lookasideSlot(key, h);
+        if (Node* hot = lookasideHit(slot, h, key)) {
+            hot->count++;
+            totalCount++;
+            updateTop(hot);
+            return;
+        }
+
+        Node* current = root;
+        uint64_t prefix = key_prefix::load(key);// 整条下降路径复用同一个前缀
+        int c = 0;
+        Node* parent = nullptr;
+        size_t depth = 0;
+
+        // 查找插入位置
+        while (current) {
+            parent = current;
+            c = compareKey(prefix, key, current);
+            stats.comparison();
+            if (c < 0) {
+                current = current->left;
+            } else if (c > 0) {
+                current = current->right;
+            } else {
+                current->count++;
+                totalCount++;
+                updateTop(current);
+                remember(slot, h, current);
+                conditionalSplay(current, depth);
+                return;
+            }
+            depth++;
+        }
+
+        // 新建节点
+        Node* newNode = nodePool.allocate(keyArena.intern(key));
+        stats.allocation();
+        newNode->parent = parent;
+
+        if (!parent) root = newNode;
+        else if (c < 0) parent->left = newNode;
+        else parent->right = newNode;
+        growAncestors(parent);
+        totalCount++;
+        updateTop(newNode);
+        remember(slot, h, newNode);
+
+        conditionalSplay(newNode, depth);
+    }
+
+    /**
+     * 由有序序列批量构建 - 时间复杂度: O(n)
+     * [first, last) 中的元素为(单词, 出现次数)，必须按单词严格升序排列（即已聚合）
+     * 节点一次性从内存池取得一段连续槽位，构建出完全平衡的树；原有节点和单词会被释放
+     * threads > 1 时并行构造节点并分治链接，适用于超大词表
+     * 所有单词先按前缀和算好偏移，一次从内存区取出，各线程只往自己的区间里复制
+     * 前 K 名在构建完成后重新选出，额外 O(n log K)
+     */
+    template<typename RandomIt>
+    void buildFromSorted(RandomIt first, RandomIt last, unsigned threads = 1) {
+        topHeap.clear();
+        std::fill(lookaside.begin(), lookaside.end(), LookasideSlot());
+        deleteTree(root);
+        root = nullptr;// 后面的分配或建树抛出异常时留下一棵合法的空树
+        totalCount = 0;
+        keyArena.clear();
+        size_t n = static_cast<size_t>(last - first);
+        std::vector<size_t> offset(n + 1, 0);
+        for (size_t i = 0; i < n; i++) offset[i + 1] = offset[i] + std::string_view(first[i].first).size();
+        char* keys = keyArena.allocate(offset[n]);
+        root = bulk_build::build(nodePool, n,
+            [&](void* storage, size_t i) {
+                std::string_view word(first[i].first);
+                std::copy(word.begin(), word.end(), keys + offset[i]);
+                Node* node = ::new (storage) Node(std::string_view(keys + offset[i], word.size()));
+                node->count = first[i].second;
+            }, threads);
+        stats.allocation(n);
+        for (RandomIt it = first; it != last; ++it) totalCount += it->second;
+        rebuildTop();
+    }
+
+    // 批量插入方法
+    void batchInsert(const std::vector<std::string_view>& words) {
+        if (words.empty()) return;
+        
+        for (const auto& word : words) {
+            if (!word.empty()) {
+                insertWithoutSplay(word);
+            }
+        }
+
+        // 最后进行一次平衡，添加空指针检查
+        if (root && getSize(root) > 0) {
+            Node* mid = findMid(root);
+            if (mid) {
+                splay(mid);
+            }
+        }
+    }
+
+    // 不立即伸展的插入；times 为本次加上的次数，近似统计提升单词时用它带入之前的估计值
+    void insertWithoutSplay(std::string_view key, long long times = 1) {
+        stats.access();
+        size_t h = 0;
+        LookasideSlot* slot = lookasideSlot(key, h);
+        if (Node* hot = lookasideHit(slot, h, key)) {
+            hot->count += times;
+            totalCount += times;
+            updateTop(hot);
+            return;
+        }
+
+        Node* current = root;
+        uint64_t prefix = key_prefix::load(key);// 整条下降路径复用同一个前缀
+        int c = 0;
+        Node* parent = nullptr;
+        size_t depth = 0;
+
+        while (current) {
+            parent = current;
+            c = compareKey(prefix, key, current);
+            stats.comparison();
+            if (c < 0) {
+                current = current->left;
+            } else if (c > 0) {
+                current = current->right;
+            } else {
+                current->count += times;
+                totalCount += times;
+                updateTop(current);
+                remember(slot, h, current);
+                conditionalSplay(current, depth);
+                return;
+            }
+            depth++;
+        }
+
+        Node* newNode = nodePool.allocate(keyArena.intern(key));
+        stats.allocation();
+        newNode->count = times;
+        newNode->parent = parent;
+
+        if (!parent) {
+            root = newNode;
+        } else if (c < 0) {
+            parent->left = newNode;
+        } else {
+            parent->right = newNode;
+        }
+        growAncestors(parent);
+        totalCount += times;
+        updateTop(newNode);
+        remember(slot, h, newNode);
+
+        conditionalSplay(newNode, depth);
+    }
+
+    // 单词已在树中时计数加一并返回 true，否则不插入、返回 false
+    bool incrementIfPresent(std::string_view key) {
+        stats.access();
+        size_t h = 0;
+        LookasideSlot* slot = lookasideSlot(key, h);
+        if (Node* hot = lookasideHit(slot, h, key)) {
+            hot->count++;
+            totalCount++;
+            updateTop(hot);
+            return true;
+        }
+
+        Node* current = root;
+        uint64_t prefix = key_prefix::load(key);// 整条下降路径复用同一个前缀
+        int c = 0;
+        size_t depth = 0;
+        while (current) {
+            c = compareKey(prefix, key, current);
+            stats.comparison();
+            if (c < 0) {
+                current = current->left;
+            } else if (c > 0) {
+                current = current->right;
+            } else {
+                current->count++;
+                totalCount++;
+                updateTop(current);
+                remember(slot, h, current);
+                conditionalSplay(current, depth);
+                return true;
+            }
+            depth++;
+        }
+        return false;
+    }
+
+    // 查询单词的出现次数，不存在时返回 0；与插入一样先查旁路表，未命中时按伸展策略调整
+    long long getCount(std::string_view key) {
+        stats.access();
+        size_t h = 0;
+        LookasideSlot* slot = lookasideSlot(key, h);
+        if (Node* hot = lookasideHit(slot, h, key)) return hot->count;
+
+        Node* current = root;
+        uint64_t prefix = key_prefix::load(key);// 整条下降路径复用同一个前缀
+        int c = 0;
+        size_t depth = 0;
+        while (current) {
+            c = compareKey(prefix, key, current);
+            stats.comparison();
+            if (c < 0) {
+                current = current->left;
+            } else if (c > 0) {
+                current = current->right;
+            } else {
+                remember(slot, h, current);
+                conditionalSplay(current, depth);
+                return current->count;
+            }
+            depth++;
+        }
+        return 0;
+    }
+
+    /**
+     * 设置旁路表的槽位数，向上取整到 2 的幂，0 表示关闭 - 时间复杂度: O(slots)
+     * 表项和命中统计都会清空
+     */
+    void setLookasideSize(size_t slots) {
+        size_t size = 0;
+        if (slots > 0) {
+            size = 1;
+            while (size < slots) size <<= 1;
+        }
+        lookaside.assign(size, LookasideSlot());
+        lookasideHits = lookasideMisses = 0;
+    }
+
+    size_t getLookasideSize() const { return lookaside.size(); }
+    size_t getLookasideHits() const { return lookasideHits; }
+    size_t getLookasideMisses() const { return lookasideMisses; }
+
+    // 找到中间节点用于平衡
+    Node* findMid(Node* node) {
+        if (!node) return nullptr;
+        
+        size_t size = getSize(node);
+        size_t target = size / 2;
+        
+        return findKthNode(node, target);
+    }
+
+    // 获取子树大小 - O(1)，由旋转和插入维护
+    size_t getSize(Node* node) const {
+        return node ? node->size : 0;
+    }
+
+    // 找到第k个节点（从0开始）- O(树高)
+    Node* findKthNode(Node* node, size_t k) {
+        while (node) {
+            size_t leftSize = getSize(node->left);
+            if (k == leftSize) return node;
+            if (k < leftSize) {
+                node = node->left;
+            } else {
+                k -= leftSize + 1;
+                node = node->right;
+            }
+        }
+        return nullptr;
+    }
+
+    // 求排名：树中字典序小于key的不同单词数 - O(树高)
+    size_t rank(std::string_view key) const {
+        size_t r = 0;
+        Node* node = root;
+        uint64_t prefix = key_prefix::load(key);
+        while (node) {
+            if (compareKey(prefix, key, node) > 0) {// node->key < key
+                r += getSize(node->left) + 1;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return r;
+    }
+
+    // 不同单词数 - O(1)
+    size_t size() const { return getSize(root); }
+
+    // 所有单词的出现次数之和 - O(1)
+    long long getTotalCount() const { return totalCount; }
+
+    /**
+     * 出现次数最多的 K 个单词，按次数降序、次数相同按字典序 - 时间复杂度: O(K log K)
+     * 前 K 名在插入时增量维护，统计过程中随时可以调用，不需要遍历和排序整棵树
+     */
+    std::vector<std::pair<std::string, long long>> topK() const {
+        std::vector<Node*> nodes(topHeap);
+        std::sort(nodes.begin(), nodes.end(), [](const Node* a, const Node* b) { return ranksBelow(b, a); });
+        std::vector<std::pair<std::string, long long>> result;
+        result.reserve(nodes.size());
+        for (const Node* x : nodes) result.emplace_back(x->key, x->count);
+        return result;
+    }
+
+    // 修改 K 并按现有计数重新选出前 K 名 - 时间复杂度: O(n log K)
+    void setTopCapacity(size_t k) {
+        topCapacity = k;
+        rebuildTop();
+    }
+
+    // 中序遍历以 node 为根的子树，收集词频信息；沿 parent 指针找后继，额外空间 O(1)
+    void traverse(Node* node, std::vector<std::pair<std::string, long long>>& freq) {
+        if (!node) return;
+        Node* stop = node->parent;
+        while (node->left) node = node->left;
+        while (node != stop) {
+            freq.emplace_back(node->key, node->count);
+            if (node->right) {
+                node = node->right;
+                while (node->left) node = node->left;
+            } else {
+                Node* p = node->parent;
+                while (p != stop && node == p->right) {
+                    node = p;
+                    p = p->parent;
+                }
+                node = p;
+            }
+        }
+    }
+
+    // 性能指标获取：旋转次数只在 Stats 统计时可用
+    uint64_t getOperations() const {
+        static_assert(Stats::enabled, "旋转次数需要 CountingStats");
+        return stats.rotations;
+    }
+    const Stats& getStats() const { return stats; }
+    Node* getRoot() { return root; }
+    const NodePool<Node>& getNodePool() const { return nodePool; }
+    const StringArena& getKeyArena() const { return keyArena; }
+
+    // 将getAverageDepth移动到public部分
+    double getAverageDepth() {
+        totalDepth = 0;
+        nodeCount = 0;
+        calculateDepth(root, 0);
+        return nodeCount > 0 ? (double)totalDepth / nodeCount : 0;
+    }
+
+    void resetCounters() {
+        stats.reset();
+    }
+
+    // 将析构函数移到public部分
+    ~SplayTree() {
+        deleteTree(root);
+    }
+};
+
+/**
+ * 自顶向下伸展树节点，不需要父节点指针
+ */
+struct TopDownNode {
+    std::string_view key;   // 单词，存放在所属树的字符串内存区中
+    uint64_t prefix;        // 单词前 8 个字节的大端序整数，与 Node 相同
+    long long count = 1;
+    TopDownNode* left = nullptr;
+    TopDownNode* right = nullptr;
+
+    TopDownNode(std::string_view k) : key(k), prefix(key_prefix::load(k)) {}
+};
+
+/**
+ * 自顶向下伸展树（Sleator–Tarjan）
+ * 在沿查找路径下降的同时完成伸展，一趟即可把目标节点变为根，
+ * 与上面自底向上的 SplayTree 相比不需要 parent 指针，也不需要回溯
+ * 节点内存池、单词内存区和前缀比较与 SplayTree 相同，两者的差别只在伸展方式
+ */
+class TopDownSplayTree {
+private:
+    TopDownNode* root = nullptr;
+    NodePool<TopDownNode> nodePool;
+    StringArena keyArena;
+
+    static int compareKey(uint64_t prefix, std::string_view key, const TopDownNode* node) {
+        return key_prefix::compare(prefix, key, node->prefix, node->key);
+    }
+
+    /**
+     * 自顶向下伸展 - 时间复杂度: 平摊O(log n)
+     * 路径上比key小的节点挂到左树，比key大的挂到右树，最后重新组装
+     * 返回新的根：key存在时为该节点，否则为最后访问的节点
+     */
+    TopDownNode* splay(std::string_view key, uint64_t prefix, TopDownNode* t) {
+        TopDownNode* l = nullptr;
+        TopDownNode* r = nullptr;
+        TopDownNode** lHook = &l;  // 左树最大节点的右指针
+        TopDownNode** rHook = &r;  // 右树最小节点的左指针
+
+        for (;;) {
+            int c = compareKey(prefix, key, t);
+            if (c < 0) {
+                if (!t->left) break;
+                if (compareKey(prefix, key, t->left) < 0) {  // Zig-Zig：先右旋
+                    TopDownNode* y = t->left;
+                    t->left = y->right;
+                    y->right = t;
+                    t = y;
+                    if (!t->left) break;
+                }
+                *rHook = t;
+                rHook = &t->left;
+                t = t->left;
+            } else if (c > 0) {
+                if (!t->right) break;
+                if (compareKey(prefix, key, t->right) > 0) {  // Zag-Zag：先左旋
+                    TopDownNode* y = t->right;
+                    t->right = y->left;
+                    y->left = t;
+                    t = y;
+                    if (!t->right) break;
+                }
+                *lHook = t;
+                lHook = &t->right;
+                t = t->right;
+            } else {
+                break;
+            }
+        }
+
+        *lHook = t->left;
+        *rHook = t->right;
+        t->left = l;
+        t->right = r;
+        return t;
+    }
+
+    // 把左孩子不断右旋上来，树被压成右链后逐个释放，额外空间 O(1)
+    void deleteTree(TopDownNode* node) {
+        while (node) {
+            if (node->left) {
+                TopDownNode* l = node->left;
+                node->left = l->right;
+                l->right = node;
+                node = l;
+            } else {
+                TopDownNode* next = node->right;
+                nodePool.deallocate(node);
+                node = next;
+            }
+        }
+    }
+
+public:
+    // 插入并伸展：已存在则计数加一，否则新节点成为根
+    void insert(std::string_view key) {
+        if (!root) {
+            root = nodePool.allocate(keyArena.intern(key));
+            return;
+        }
+
+        uint64_t prefix = key_prefix::load(key);// 伸展和随后的比较复用同一个前缀
+        root = splay(key, prefix, root);
+        int c = compareKey(prefix, key, root);
+        if (c == 0) {
+            root->count++;
+            return;
+        }
+
+        TopDownNode* newNode = nodePool.allocate(keyArena.intern(key));
+        if (c < 0) {
+            newNode->left = root->left;
+            newNode->right = root;
+            root->left = nullptr;
+        } else {
+            newNode->right = root->right;
+            newNode->left = root;
+            root->right = nullptr;
+        }
+        root = newNode;
+    }
+
+    // Morris 中序遍历：借用前驱节点空闲的右指针回到当前节点，结束后树恢复原状，额外空间 O(1)
+    void traverse(TopDownNode* node, std::vector<std::pair<std::string, long long>>& freq) {
+        while (node) {
+            if (!node->left) {
+                freq.emplace_back(node->key, node->count);
+                node = node->right;
+                continue;
+            }
+            TopDownNode* pre = node->left;
+            while (pre->right && pre->right != node) pre = pre->right;
+            if (!pre->right) {
+                pre->right = node;
+                node = node->left;
+            } else {
+                pre->right = nullptr;
+                freq.emplace_back(node->key, node->count);
+                node = node->right;
+            }
+        }
+    }
+
+    // 查询出现次数并把查找路径的终点伸展到根，不存在时返回 0
+    long long getCount(std::string_view key) {
+        if (!root) return 0;
+        uint64_t prefix = key_prefix::load(key);
+        root = splay(key, prefix, root);
+        return compareKey(prefix, key, root) == 0 ? root->count : 0;
+    }
+
+    TopDownNode* getRoot() { return root; }
+
+    ~TopDownSplayTree() {
+        deleteTree(root);
+    }
+};
+
+// 二叉树
+class BST {
+private:
+    struct BSTNode {
+        std::string key;
+        long long count = 1;
+        BSTNode* left = nullptr;
+        BSTNode* right = nullptr;
+        
+        BSTNode(std::string_view k) : key(k) {}
+    };
+    
+    BSTNode* root = nullptr;
+    uint64_t totalDepth = 0;// 深度之和，BST 退化成链时约为 n^2 / 2，int 会溢出
+    size_t nodeCount = 0;
+    uint64_t accessCount = 0;  // 添加访问计数器
+    uint64_t compareCount = 0; // 添加比较次数计数器
+
+    // 把左孩子不断右旋上来，树被压成右链后逐个释放，额外空间 O(1)
+    void deleteTree(BSTNode* node) {
+        while (node) {
+            if (node->left) {
+                BSTNode* l = node->left;
+                node->left = l->right;
+                l->right = node;
+                node = l;
+            } else {
+                BSTNode* next = node->right;
+                delete node;
+                node = next;
+            }
+        }
+    }
+
+public:
+    // 沿查找路径向下，link 指向需要改写的孩子指针；计数与递归版本一致（每下降一层访问一次）
+    void insert(std::string_view key) {
+        BSTNode** link = &root;
+        for (;;) {
+            accessCount++;
+            BSTNode* node = *link;
+            if (!node) {
+                *link = new BSTNode(key);
+                return;
+            }
+
+            compareCount++;
+            if (key < node->key)
+                link = &node->left;
+            else if (key > node->key)
+                link = &node->right;
+            else {
+                node->count++;
+                return;
+            }
+        }
+    }
+    
+    double getAverageDepth() {
+        totalDepth = 0;
+        nodeCount = 0;
+        calculateDepth(root, 0);
+        return nodeCount > 0 ? (double)totalDepth / nodeCount : 0;
+    }
+    
+    // Morris 中序遍历：借用前驱节点空闲的右指针回到当前节点，结束后树恢复原状，额外空间 O(1)
+    void traverse(BSTNode* node, std::vector<std::pair<std::string, long long>>& freq) {
+        while (node) {
+            if (!node->left) {
+                freq.push_back({node->key, node->count});
+                node = node->right;
+                continue;
+            }
+            BSTNode* pre = node->left;
+            while (pre->right && pre->right != node) pre = pre->right;
+            if (!pre->right) {
+                pre->right = node;
+                node = node->left;
+            } else {
+                pre->right = nullptr;
+                freq.push_back({node->key, node->count});
+                node = node->right;
+            }
+        }
+    }
+    
+    std::vector<std::pair<std::string, long long>> getFrequencies() {
+        std::vector<std::pair<std::string, long long>> freq;
+        traverse(root, freq);
+        return freq;
+    }
+
+    void resetCounters() {
+        accessCount = 0;
+        compareCount = 0;
+    }
+    
+    uint64_t getAccessCount() const { return accessCount; }
+    uint64_t getCompareCount() const { return compareCount; }
+
+    BSTNode* search(std::string_view key) {
+        accessCount++;
+        BSTNode* current = root;
+        while (current) {
+            compareCount++;
+            if (key < current->key)
+                current = current->left;
+            else if (key > current->key)
+                current = current->right;
+            else
+                return current;
+        }
+        return nullptr;
+    }
+
+    // 查询出现次数，不存在时返回 0
+    long long getCount(std::string_view key) {
+        BSTNode* node = search(key);
+        return node ? node->count : 0;
+    }
+
+    // 将析构函数移到public部分
+    ~BST() {
+        deleteTree(root);
+    }
+
+private:
+    // 显式栈代替递归：每次弹出一个节点后先压右孩子再压左孩子，退化成链时栈深度不超过 1
+    void calculateDepth(BSTNode* node, size_t depth) {
+        std::vector<std::pair<BSTNode*, size_t>> stack;
+        if (node) stack.push_back({node, depth});
+        while (!stack.empty()) {
+            auto [x, d] = stack.back();
+            stack.pop_back();
+            totalDepth += d;
+            nodeCount++;
+            if (x->right) stack.push_back({x->right, d + 1});
+            if (x->left) stack.push_back({x->left, d + 1});
+        }
+    }
+};
+
+} // namespace word_frequency
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+/**
+ * Zipf(s) 分布采样：排名 i（从 0 开始）被取到的概率正比于 1/(i+1)^s
+ * 预先计算累积分布，每次采样二分查找 - 构造 O(n)，采样 O(log n)
+ * 采样不修改对象，多个线程可以各用自己的随机数引擎共享同一个生成器
+ */
+class ZipfGenerator {
+public:
+    ZipfGenerator(size_t n, double s) : cdf(n) {
+        double sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += 1.0 / std::pow(double(i + 1), s);
+            cdf[i] = sum;
+        }
+        for (auto& c : cdf) c /= sum;
+    }
+
+    template<typename Gen>
+    size_t operator()(Gen& gen) const {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(gen);
+        size_t i = static_cast<size_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+        return std::min(i, cdf.size() - 1);// 舍入误差可能让最后一项略小于 1
+    }
+
+private:
+    std::vector<double> cdf;
+};